@@ -81,302 +81,358 @@
 // Helper Macro to iterate a specific RK K. // Only Callable from within the solver
 // This helper gets a little ugly when branching for all the specific cases using the templated kernel. Should ultimately perform better tho.
 // OMG I am so sorry... but this is actually quite a bit faster than before, because we dont use function pointers any more^^
+// CALCULATE_K_INTO evaluates the stage 'index', i.e. with the halo of that stage, into the k matrix slot 'slot'.
+// If evolve_reservoir is false, the reservoir is only read for the coupling and its k is not evaluated, see --reservoirSubcycle.
+// Higher order stencils and the spectral Laplacian (radius 0) of the scalar kernel, see --stencil. Only the reservoir and the noise are branched for,
+// because the pulse, pump and potential loops are empty if they are not used.
+#define CALCULATE_K_STENCIL( index, radius, evolve_reservoir )                                                                                                                                                                                            \
+    if ( system.use_reservoir ) {                                                                                                                                                                                                                         \
+        if ( system.use_stochastic ) {                                                                                                                                                                                                                    \
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, true, true, true, evolve_reservoir, false, radius )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );  \
+        } else {                                                                                                                                                                                                                                          \
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, true, true, false, evolve_reservoir, false, radius )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io ); \
+        }                                                                                                                                                                                                                                                 \
+    } else if ( system.use_adiabatic_reservoir ) {                                                                                                                                                                                                        \
+        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, true, false, true, true, radius )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                 \
+    } else if ( system.use_stochastic ) {                                                                                                                                                                                                                 \
+        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, true, true, true, false, radius )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                 \
+    } else {                                                                                                                                                                                                                                              \
+        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, true, false, true, false, radius )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                \
+    }
+
 #ifdef NO_CALCULATE_K
-    #define CALCULATE_K( index, input_wavefunction, input_reservoir ) {};
+    #define CALCULATE_K_INTO( index, slot, input_wavefunction, input_reservoir, evolve_reservoir ) {};
 #else
     #ifdef BENCH
         #ifdef USE_CPU
-            #define CALCULATE_K( index, input_wavefunction, input_reservoir )                                                                                                                                                                                                                                                                                   \
-                {                                                                                                                                                                                                                                                                                                                                               \
-                    const Type::uint32 current_halo = system.p.halo_size - index;                                                                                                                                                                                                                                                                               \
-                    auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                                                                               \
-                    Solver::InputOutput io{ matrix.input_wavefunction##_plus.getDevicePtr( subgrid ), matrix.input_wavefunction##_minus.getDevicePtr( subgrid ),     matrix.input_wavefunction##_iplus.getDevicePtr( subgrid ),      matrix.input_wavefunction##_iminus.getDevicePtr( subgrid ), matrix.input_reservoir##_plus.getDevicePtr( subgrid ),         \
-                                            matrix.input_reservoir##_minus.getDevicePtr( subgrid ),   matrix.k_wavefunction_plus.getDevicePtr( subgrid, index - 1 ), matrix.k_wavefunction_minus.getDevicePtr( subgrid, index - 1 ), matrix.k_reservoir_plus.getDevicePtr( subgrid, index - 1 ), matrix.k_reservoir_minus.getDevicePtr( subgrid, index - 1 ) }; \
-                    CALL_SUBGRID_KERNEL_MI( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                                                                         \
-                    CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                                                                            \
+            #define CALCULATE_K_INTO( index, slot, input_wavefunction, input_reservoir, evolve_reservoir )                                                                                                                                                                                                                                                                        \
+                {                                                                                                                                                                                                                                                                                                                                                                 \
+                    const Type::uint32 current_halo = stageHalo( index );                                                                                                                                                                                                                                                                                                         \
+                    auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                                                                                                 \
+                    Solver::InputOutput io{ matrix.input_wavefunction##_plus.getDevicePtr( subgrid ), matrix.input_wavefunction##_minus.getDevicePtr( subgrid ),     matrix.input_wavefunction##_iplus.getDevicePtr( subgrid ),      matrix.input_wavefunction##_iminus.getDevicePtr( subgrid ), matrix.input_reservoir##_plus.getDevicePtr( subgrid ),                           \
+                                            matrix.input_reservoir##_minus.getDevicePtr( subgrid ),   matrix.k_wavefunction_plus.getDevicePtr( subgrid, slot ), matrix.k_wavefunction_minus.getDevicePtr( subgrid, slot ), matrix.k_reservoir_plus.getDevicePtr( subgrid, slot ), matrix.k_reservoir_minus.getDevicePtr( subgrid, slot ) };                                       \
+                    CALL_SUBGRID_KERNEL_MI( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                                                                                           \
+                    CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                                                                                              \
                 }
         #else
-            #define CALCULATE_K( index, input_wavefunction, input_reservoir )                                                                                                                                                                                                                                                                                   \
-                {                                                                                                                                                                                                                                                                                                                                               \
-                    const Type::uint32 current_halo = system.p.halo_size - index;                                                                                                                                                                                                                                                                               \
-                    auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                                                                               \
-                    Solver::InputOutput io{ matrix.input_wavefunction##_plus.getDevicePtr( subgrid ), matrix.input_wavefunction##_minus.getDevicePtr( subgrid ),     matrix.input_wavefunction##_iplus.getDevicePtr( subgrid ),      matrix.input_wavefunction##_iminus.getDevicePtr( subgrid ), matrix.input_reservoir##_plus.getDevicePtr( subgrid ),         \
-                                            matrix.input_reservoir##_minus.getDevicePtr( subgrid ),   matrix.k_wavefunction_plus.getDevicePtr( subgrid, index - 1 ), matrix.k_wavefunction_minus.getDevicePtr( subgrid, index - 1 ), matrix.k_reservoir_plus.getDevicePtr( subgrid, index - 1 ), matrix.k_reservoir_minus.getDevicePtr( subgrid, index - 1 ) }; \
-                    CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                                                                            \
+            #define CALCULATE_K_INTO( index, slot, input_wavefunction, input_reservoir, evolve_reservoir )                                                                                                                                                                                                                                                                        \
+                {                                                                                                                                                                                                                                                                                                                                                                 \
+                    const Type::uint32 current_halo = stageHalo( index );                                                                                                                                                                                                                                                                                                         \
+                    auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                                                                                                 \
+                    Solver::InputOutput io{ matrix.input_wavefunction##_plus.getDevicePtr( subgrid ), matrix.input_wavefunction##_minus.getDevicePtr( subgrid ),     matrix.input_wavefunction##_iplus.getDevicePtr( subgrid ),      matrix.input_wavefunction##_iminus.getDevicePtr( subgrid ), matrix.input_reservoir##_plus.getDevicePtr( subgrid ),                           \
+                                            matrix.input_reservoir##_minus.getDevicePtr( subgrid ),   matrix.k_wavefunction_plus.getDevicePtr( subgrid, slot ), matrix.k_wavefunction_minus.getDevicePtr( subgrid, slot ), matrix.k_reservoir_plus.getDevicePtr( subgrid, slot ), matrix.k_reservoir_minus.getDevicePtr( subgrid, slot ) };                                       \
+                    CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                                                                                              \
                 }
         #endif
     #else
-        #define CALCULATE_K( index, input_wavefunction, input_reservoir )                                                                                                                                                                                                                         \
-            {                                                                                                                                                                                                                                                                                     \
-                const Type::uint32 current_halo = system.p.halo_size - index;                                                                                                                                                                                                                     \
-                auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                     \
-                Solver::InputOutput io{ matrix.input_wavefunction##_plus.getDevicePtr( subgrid ),      matrix.input_wavefunction##_minus.getDevicePtr( subgrid ),      matrix.input_reservoir##_plus.getDevicePtr( subgrid ),      matrix.input_reservoir##_minus.getDevicePtr( subgrid ),        \
-                                        matrix.k_wavefunction_plus.getDevicePtr( subgrid, index - 1 ), matrix.k_wavefunction_minus.getDevicePtr( subgrid, index - 1 ), matrix.k_reservoir_plus.getDevicePtr( subgrid, index - 1 ), matrix.k_reservoir_minus.getDevicePtr( subgrid, index - 1 ) }; \
-                if ( not system.use_twin_mode ) {                                                                                                                                                                                                                                                 \
-                    if ( system.use_reservoir ) {                                                                                                                                                                                                                                                 \
-                        if ( system.use_pulses ) {                                                                                                                                                                                                                                                \
-                            if ( system.use_pumps ) {                                                                                                                                                                                                                                             \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            } else {                                                                                                                                                                                                                                                              \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            }                                                                                                                                                                                                                                                                     \
-                        } else {                                                                                                                                                                                                                                                                  \
-                            if ( system.use_pumps ) {                                                                                                                                                                                                                                             \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            } else {                                                                                                                                                                                                                                                              \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                           \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            }                                                                                                                                                                                                                                                                     \
-                        }                                                                                                                                                                                                                                                                         \
-                    } else {                                                                                                                                                                                                                                                                      \
-                        if ( system.use_pulses ) {                                                                                                                                                                                                                                                \
-                            if ( system.use_pumps ) {                                                                                                                                                                                                                                             \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            } else {                                                                                                                                                                                                                                                              \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                           \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            }                                                                                                                                                                                                                                                                     \
-                        } else {                                                                                                                                                                                                                                                                  \
-                            if ( system.use_pumps ) {                                                                                                                                                                                                                                             \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                           \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            } else {                                                                                                                                                                                                                                                              \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                           \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                           \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                          \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            }                                                                                                                                                                                                                                                                     \
-                        }                                                                                                                                                                                                                                                                         \
-                    }                                                                                                                                                                                                                                                                             \
-                } else {                                                                                                                                                                                                                                                                          \
-                    if ( system.use_reservoir ) {                                                                                                                                                                                                                                                 \
-                        if ( system.use_pulses ) {                                                                                                                                                                                                                                                \
-                            if ( system.use_pumps ) {                                                                                                                                                                                                                                             \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            } else {                                                                                                                                                                                                                                                              \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            }                                                                                                                                                                                                                                                                     \
-                        } else {                                                                                                                                                                                                                                                                  \
-                            if ( system.use_pumps ) {                                                                                                                                                                                                                                             \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            } else {                                                                                                                                                                                                                                                              \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            }                                                                                                                                                                                                                                                                     \
-                        }                                                                                                                                                                                                                                                                         \
-                    } else {                                                                                                                                                                                                                                                                      \
-                        if ( system.use_pulses ) {                                                                                                                                                                                                                                                \
-                            if ( system.use_pumps ) {                                                                                                                                                                                                                                             \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            } else {                                                                                                                                                                                                                                                              \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            }                                                                                                                                                                                                                                                                     \
-                        } else {                                                                                                                                                                                                                                                                  \
-                            if ( system.use_pumps ) {                                                                                                                                                                                                                                             \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            } else {                                                                                                                                                                                                                                                              \
-                                if ( system.use_potentials ) {                                                                                                                                                                                                                                    \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    }                                                                                                                                                                                                                                                             \
-                                } else {                                                                                                                                                                                                                                                          \
-                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
-                                    } else {                                                                                                                                                                                                                                                      \
-                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                           \
-                                    }                                                                                                                                                                                                                                                             \
-                                }                                                                                                                                                                                                                                                                 \
-                            }                                                                                                                                                                                                                                                                     \
-                        }                                                                                                                                                                                                                                                                         \
-                    }                                                                                                                                                                                                                                                                             \
-                }                                                                                                                                                                                                                                                                                 \
+        #define CALCULATE_K_INTO( index, slot, input_wavefunction, input_reservoir, evolve_reservoir )                                                                                                                                                                                                              \
+            {                                                                                                                                                                                                                                                                                                       \
+                const Type::uint32 current_halo = stageHalo( index );                                                                                                                                                                                                                                               \
+                auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                                       \
+                Solver::InputOutput io{ matrix.input_wavefunction##_plus.getDevicePtr( subgrid ),      matrix.input_wavefunction##_minus.getDevicePtr( subgrid ),      matrix.input_reservoir##_plus.getDevicePtr( subgrid ),      matrix.input_reservoir##_minus.getDevicePtr( subgrid ),                          \
+                                        matrix.k_wavefunction_plus.getDevicePtr( subgrid, slot ), matrix.k_wavefunction_minus.getDevicePtr( subgrid, slot ), matrix.k_reservoir_plus.getDevicePtr( subgrid, slot ), matrix.k_reservoir_minus.getDevicePtr( subgrid, slot ) };                                       \
+                if ( system.p.stencil_radius == 0 ) {                                                                                                                                                                                                                                                               \
+                    CALCULATE_K_STENCIL( index, 0, evolve_reservoir )                                                                                                                                                                                                                                               \
+                } else if ( system.p.stencil_radius == 2 ) {                                                                                                                                                                                                                                                        \
+                    CALCULATE_K_STENCIL( index, 2, evolve_reservoir )                                                                                                                                                                                                                                               \
+                } else if ( system.p.stencil_radius == 3 ) {                                                                                                                                                                                                                                                        \
+                    CALCULATE_K_STENCIL( index, 3, evolve_reservoir )                                                                                                                                                                                                                                               \
+                } else if ( not system.use_twin_mode ) {                                                                                                                                                                                                                                                            \
+                    if ( system.use_reservoir ) {                                                                                                                                                                                                                                                                   \
+                        if ( system.use_pulses ) {                                                                                                                                                                                                                                                                  \
+                            if ( system.use_pumps ) {                                                                                                                                                                                                                                                               \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, true, true, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, true, true, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, true, false, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, true, false, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, false, true, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, false, true, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, false, false, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, true, false, false, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            }                                                                                                                                                                                                                                                                                       \
+                        } else {                                                                                                                                                                                                                                                                                    \
+                            if ( system.use_pumps ) {                                                                                                                                                                                                                                                               \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, true, true, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, true, true, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, true, false, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, true, false, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, false, true, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, false, true, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, false, false, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, true, false, false, false, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                           \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            }                                                                                                                                                                                                                                                                                       \
+                        }                                                                                                                                                                                                                                                                                           \
+                    } else if ( system.use_adiabatic_reservoir ) {                                                                                                                                                                                                                                                  \
+                        if ( system.use_pulses ) {                                                                                                                                                                                                                                                                  \
+                            if ( system.use_potentials ) {                                                                                                                                                                                                                                                          \
+                                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, true, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                           \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, false, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                          \
+                            }                                                                                                                                                                                                                                                                                       \
+                        } else {                                                                                                                                                                                                                                                                                    \
+                            if ( system.use_potentials ) {                                                                                                                                                                                                                                                          \
+                                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, true, true, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                          \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, true, false, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                         \
+                            }                                                                                                                                                                                                                                                                                       \
+                        }                                                                                                                                                                                                                                                                                           \
+                    } else {                                                                                                                                                                                                                                                                                        \
+                        if ( system.use_pulses ) {                                                                                                                                                                                                                                                                  \
+                            if ( system.use_pumps ) {                                                                                                                                                                                                                                                               \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                               \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                               \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                              \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                               \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                              \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                              \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, true, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                             \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            }                                                                                                                                                                                                                                                                                       \
+                        } else {                                                                                                                                                                                                                                                                                    \
+                            if ( system.use_pumps ) {                                                                                                                                                                                                                                                               \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                               \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                              \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                              \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                             \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                              \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                             \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                             \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( false, false, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                            \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            }                                                                                                                                                                                                                                                                                       \
+                        }                                                                                                                                                                                                                                                                                           \
+                    }                                                                                                                                                                                                                                                                                               \
+                } else {                                                                                                                                                                                                                                                                                            \
+                    if ( system.use_reservoir ) {                                                                                                                                                                                                                                                                   \
+                        if ( system.use_pulses ) {                                                                                                                                                                                                                                                                  \
+                            if ( system.use_pumps ) {                                                                                                                                                                                                                                                               \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, true, true, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, true, true, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, true, false, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, true, false, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, false, true, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, false, true, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, false, false, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, true, false, false, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            }                                                                                                                                                                                                                                                                                       \
+                        } else {                                                                                                                                                                                                                                                                                    \
+                            if ( system.use_pumps ) {                                                                                                                                                                                                                                                               \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, true, true, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                               \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, true, true, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, true, false, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, true, false, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, false, true, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                              \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, false, true, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, false, false, true, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                             \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, true, false, false, false, false, evolve_reservoir )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                            \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            }                                                                                                                                                                                                                                                                                       \
+                        }                                                                                                                                                                                                                                                                                           \
+                    } else if ( system.use_adiabatic_reservoir ) {                                                                                                                                                                                                                                                  \
+                        if ( system.use_pulses ) {                                                                                                                                                                                                                                                                  \
+                            if ( system.use_potentials ) {                                                                                                                                                                                                                                                          \
+                                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, true, true, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                            \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, true, false, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                           \
+                            }                                                                                                                                                                                                                                                                                       \
+                        } else {                                                                                                                                                                                                                                                                                    \
+                            if ( system.use_potentials ) {                                                                                                                                                                                                                                                          \
+                                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, true, true, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                           \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, true, false, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                          \
+                            }                                                                                                                                                                                                                                                                                       \
+                        }                                                                                                                                                                                                                                                                                           \
+                    } else {                                                                                                                                                                                                                                                                                        \
+                        if ( system.use_pulses ) {                                                                                                                                                                                                                                                                  \
+                            if ( system.use_pumps ) {                                                                                                                                                                                                                                                               \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                 \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                               \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                               \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                               \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, true, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                              \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            }                                                                                                                                                                                                                                                                                       \
+                        } else {                                                                                                                                                                                                                                                                                    \
+                            if ( system.use_pumps ) {                                                                                                                                                                                                                                                               \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, true, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                                \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, true, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                               \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, true, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                               \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, true, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                              \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            } else {                                                                                                                                                                                                                                                                                \
+                                if ( system.use_potentials ) {                                                                                                                                                                                                                                                      \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, false, true, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                               \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, false, true, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                              \
+                                    }                                                                                                                                                                                                                                                                               \
+                                } else {                                                                                                                                                                                                                                                                            \
+                                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                  \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, false, false, true )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                              \
+                                    } else {                                                                                                                                                                                                                                                                        \
+                                        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_scalar<GCC_EXPAND_VA_ARGS( true, false, false, false, false, false )>, "K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io );                                                             \
+                                    }                                                                                                                                                                                                                                                                               \
+                                }                                                                                                                                                                                                                                                                                   \
+                            }                                                                                                                                                                                                                                                                                       \
+                        }                                                                                                                                                                                                                                                                                           \
+                    }                                                                                                                                                                                                                                                                                               \
+                }                                                                                                                                                                                                                                                                                                   \
             }
 
     #endif
 #endif
+// Evaluates k_index into its own slot of the k matrices.
+#define CALCULATE_K( index, input_wavefunction, input_reservoir ) CALCULATE_K_INTO( index, index - 1, input_wavefunction, input_reservoir, true )
+
 // Only Callable from within the solver
 #ifdef NO_INTERMEDIATE_SUM_K
-    #define INTERMEDIATE_SUM_K( index, ... ) {};
+    #define INTERMEDIATE_SUM_K_RESERVOIR( index, evolve_reservoir, ... ) {};
 #else
     #ifdef BENCH
-        #define INTERMEDIATE_SUM_K( index, ... )                                                                                                                                                                                                                                                                            \
+        #define INTERMEDIATE_SUM_K_RESERVOIR( index, evolve_reservoir, ... )                                                                                                                                                                                                                                                                            \
             {                                                                                                                                                                                                                                                                                                               \
-                const Type::uint32 current_halo = system.p.halo_size - index;                                                                                                                                                                                                                                               \
+                const Type::uint32 current_halo = stageHalo( index );                                                                                                                                                                                                                                                       \
                 auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                                               \
                 Solver::InputOutput io{ matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.wavefunction_minus.getDevicePtr( subgrid ),       matrix.wavefunction##_iplus.getDevicePtr( subgrid ),      matrix.wavefunction##_iminus.getDevicePtr( subgrid ), matrix.reservoir_plus.getDevicePtr( subgrid ),           \
                                         matrix.reservoir_minus.getDevicePtr( subgrid ),   matrix.buffer_wavefunction_plus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_minus.getDevicePtr( subgrid ), matrix.buffer_reservoir_plus.getDevicePtr( subgrid ), matrix.buffer_reservoir_minus.getDevicePtr( subgrid ) }; \
@@ -384,190 +440,204 @@
                 CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                  \
             };
     #else
-        #define INTERMEDIATE_SUM_K( index, ... )                                                                                                                                                                                                                                                                                                                                                                                                                              \
+        #define INTERMEDIATE_SUM_K_RESERVOIR( index, evolve_reservoir, ... )                                                                                                                                                                                                                                                                                                                                                                                                                              \
+            {                                                                                                                                                                                                                                                                                                                                                                                                                                                                                             \
+                const Type::uint32 current_halo = stageHalo( index );                                                                                                                                                                                                                                                                                                                                                                                                                                     \
+                auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                                                                                                                                                                                                                             \
+                Solver::InputOutput io{ matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.reservoir_plus.getDevicePtr( subgrid ), matrix.reservoir_minus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_plus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_minus.getDevicePtr( subgrid ), matrix.buffer_reservoir_plus.getDevicePtr( subgrid ), matrix.buffer_reservoir_minus.getDevicePtr( subgrid ) };                             \
+                Type::complex *k_vec_wf_plus = matrix.k_wavefunction_plus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                                                        \
+                if ( system.use_reservoir ) {                                                                                                                                                                                                                                                                                                                                                                                                                                                             \
+                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                                                                                        \
+                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                                        \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                                                      \
+                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                          \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                                                       \
+                        }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
+                    } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                              \
+                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                                        \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                                                     \
+                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                          \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                                                      \
+                        }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
+                    }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
+                    if ( evolve_reservoir ) {                                                                                                                                                                                                                                                                                                                                                                                                                                                             \
+                        Type::complex *k_vec_res_plus = matrix.k_reservoir_plus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                                                  \
+                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                                        \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_plus, io.out_rv_plus, k_vec_res_plus );                                                                                                                                                                                    \
+                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                          \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_plus, io.out_rv_plus, k_vec_res_plus );                                                                                                                                                                                     \
+                        }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
+                    }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
+                    if ( system.use_twin_mode ) {                                                                                                                                                                                                                                                                                                                                                                                                                                                         \
+                        Type::complex *k_vec_wf_minus = matrix.k_wavefunction_minus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                                              \
+                        if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                                                                                    \
+                            if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                                    \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                                               \
+                            } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                      \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                                                \
+                            }                                                                                                                                                                                                                                                                                                                                                                                                                                                                             \
+                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                          \
+                            if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                                    \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                                              \
+                            } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                      \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                                               \
+                            }                                                                                                                                                                                                                                                                                                                                                                                                                                                                             \
+                        }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
+                        if ( evolve_reservoir ) {                                                                                                                                                                                                                                                                                                                                                                                                                                                         \
+                            Type::complex *k_vec_res_minus = matrix.k_reservoir_minus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                                            \
+                            if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                                    \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_minus, io.out_rv_minus, k_vec_res_minus );                                                                                                                                                                             \
+                            } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                      \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_minus, io.out_rv_minus, k_vec_res_minus );                                                                                                                                                                              \
+                            }                                                                                                                                                                                                                                                                                                                                                                                                                                                                             \
+                        }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
+                    }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
+                } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                                  \
+                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                                                                                        \
+                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                                        \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                                                     \
+                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                          \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                                                      \
+                        }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
+                    } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                              \
+                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                                        \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                                                    \
+                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                          \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                                                     \
+                        }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
+                    }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
+                    if ( system.use_twin_mode ) {                                                                                                                                                                                                                                                                                                                                                                                                                                                         \
+                        Type::complex *k_vec_wf_minus = matrix.k_wavefunction_minus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                                              \
+                        if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                                                                                    \
+                            if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                                    \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                                              \
+                            } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                      \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                                               \
+                            }                                                                                                                                                                                                                                                                                                                                                                                                                                                                             \
+                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                          \
+                            if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                                    \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                                             \
+                            } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                                      \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                                              \
+                            }                                                                                                                                                                                                                                                                                                                                                                                                                                                                             \
+                        }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
+                    }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
+                }                                                                                                                                                                                                                                                                                                                                                                                                                                                                                         \
+            };
+    #endif
+#endif
+// The reservoir is only summed if evolve_reservoir is true. It is held fixed otherwise, see --reservoirSubcycle.
+#define INTERMEDIATE_SUM_K( index, ... ) INTERMEDIATE_SUM_K_RESERVOIR( index, true, __VA_ARGS__ )
+
+// Only Callable from within the solver
+#ifdef NO_FINAL_SUM_K
+    #define FINAL_SUM_K_RESERVOIR( index, evolve_reservoir, ... ) {};
+#else
+    #ifdef BENCH
+        #define FINAL_SUM_K_RESERVOIR( index, evolve_reservoir, ... )                                                                                                                                                                                                                                                                 \
+            {                                                                                                                                                                                                                                                                                             \
+                Type::uint32 current_halo = stageHalo( 0 );                                                                                                                                                                                                                                               \
+                auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                             \
+                Solver::InputOutput io{ matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.wavefunction##_iplus.getDevicePtr( subgrid ), matrix.wavefunction##_iminus.getDevicePtr( subgrid ), matrix.reservoir_plus.getDevicePtr( subgrid ),    \
+                                        matrix.reservoir_minus.getDevicePtr( subgrid ),   matrix.wavefunction_plus.getDevicePtr( subgrid ),  matrix.wavefunction_minus.getDevicePtr( subgrid ),   matrix.reservoir_plus.getDevicePtr( subgrid ),        matrix.reservoir_minus.getDevicePtr( subgrid ) }; \
+                Type::complex *k_vec_wf_plus = matrix.k_wavefunction_plus.getDevicePtr( subgrid );                                                                                                                                                                                                        \
+                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                \
+            };
+    #else
+        #define FINAL_SUM_K_RESERVOIR( index, evolve_reservoir, ... )                                                                                                                                                                                                                                                                                                                                                                                                         \
             {                                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
-                const Type::uint32 current_halo = system.p.halo_size - index;                                                                                                                                                                                                                                                                                                                                                                                                 \
+                Type::uint32 current_halo = stageHalo( 0 );                                                                                                                                                                                                                                                                                                                                                                                                                   \
                 auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                                                                                                                                                                                                 \
-                Solver::InputOutput io{ matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.reservoir_plus.getDevicePtr( subgrid ), matrix.reservoir_minus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_plus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_minus.getDevicePtr( subgrid ), matrix.buffer_reservoir_plus.getDevicePtr( subgrid ), matrix.buffer_reservoir_minus.getDevicePtr( subgrid ) }; \
+                Solver::InputOutput io{ matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.reservoir_plus.getDevicePtr( subgrid ), matrix.reservoir_minus.getDevicePtr( subgrid ), matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.reservoir_plus.getDevicePtr( subgrid ), matrix.reservoir_minus.getDevicePtr( subgrid ) };                             \
                 Type::complex *k_vec_wf_plus = matrix.k_wavefunction_plus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                            \
                 if ( system.use_reservoir ) {                                                                                                                                                                                                                                                                                                                                                                                                                                 \
                     if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                                                            \
                         if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                            \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                          \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                                                          \
                         } else {                                                                                                                                                                                                                                                                                                                                                                                                                                              \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                           \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                                                           \
                         }                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
                     } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                  \
                         if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                            \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                         \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                                                         \
                         } else {                                                                                                                                                                                                                                                                                                                                                                                                                                              \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                          \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                                                          \
                         }                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
                     }                                                                                                                                                                                                                                                                                                                                                                                                                                                         \
-                    Type::complex *k_vec_res_plus = matrix.k_reservoir_plus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                          \
-                    if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                                \
-                        CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_plus, io.out_rv_plus, k_vec_res_plus );                                                                                                                                                            \
-                    } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                  \
-                        CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_plus, io.out_rv_plus, k_vec_res_plus );                                                                                                                                                             \
+                    if ( evolve_reservoir ) {                                                                                                                                                                                                                                                                                                                                                                                                                                 \
+                        Type::complex *k_vec_res_plus = matrix.k_reservoir_plus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                      \
+                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                            \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_plus, k_vec_res_plus );                                                                                                                                                                        \
+                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                                              \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_plus, k_vec_res_plus );                                                                                                                                                                         \
+                        }                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
                     }                                                                                                                                                                                                                                                                                                                                                                                                                                                         \
                     if ( system.use_twin_mode ) {                                                                                                                                                                                                                                                                                                                                                                                                                             \
                         Type::complex *k_vec_wf_minus = matrix.k_wavefunction_minus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                  \
                         if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                                                        \
                             if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                        \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                   \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                                                    \
                             } else {                                                                                                                                                                                                                                                                                                                                                                                                                                          \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                    \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                                                     \
                             }                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
                         } else {                                                                                                                                                                                                                                                                                                                                                                                                                                              \
                             if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                        \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                  \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                                                   \
                             } else {                                                                                                                                                                                                                                                                                                                                                                                                                                          \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                   \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                                                    \
                             }                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
                         }                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
-                        Type::complex *k_vec_res_minus = matrix.k_reservoir_minus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                    \
-                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                            \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_minus, io.out_rv_minus, k_vec_res_minus );                                                                                                                                                     \
-                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                                              \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_minus, io.out_rv_minus, k_vec_res_minus );                                                                                                                                                      \
+                        if ( evolve_reservoir ) {                                                                                                                                                                                                                                                                                                                                                                                                                             \
+                            Type::complex *k_vec_res_minus = matrix.k_reservoir_minus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                \
+                            if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                        \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_minus, k_vec_res_minus );                                                                                                                                                                  \
+                            } else {                                                                                                                                                                                                                                                                                                                                                                                                                                          \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_minus, k_vec_res_minus );                                                                                                                                                                   \
+                            }                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
                         }                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
                     }                                                                                                                                                                                                                                                                                                                                                                                                                                                         \
                 } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                      \
                     if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                                                            \
                         if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                            \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                         \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                                                         \
                         } else {                                                                                                                                                                                                                                                                                                                                                                                                                                              \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                          \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                                                          \
                         }                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
                     } else {                                                                                                                                                                                                                                                                                                                                                                                                                                                  \
                         if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                            \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                        \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                                                        \
                         } else {                                                                                                                                                                                                                                                                                                                                                                                                                                              \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, io.out_wf_plus, k_vec_wf_plus );                                                                                                                                                         \
+                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                                                         \
                         }                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
                     }                                                                                                                                                                                                                                                                                                                                                                                                                                                         \
                     if ( system.use_twin_mode ) {                                                                                                                                                                                                                                                                                                                                                                                                                             \
                         Type::complex *k_vec_wf_minus = matrix.k_wavefunction_minus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                                  \
                         if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                                                        \
                             if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                        \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                  \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                                                   \
                             } else {                                                                                                                                                                                                                                                                                                                                                                                                                                          \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                   \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                                                    \
                             }                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
                         } else {                                                                                                                                                                                                                                                                                                                                                                                                                                              \
                             if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                                        \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                 \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                                                  \
                             } else {                                                                                                                                                                                                                                                                                                                                                                                                                                          \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, io.out_wf_minus, k_vec_wf_minus );                                                                                                                                                  \
+                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                                                   \
                             }                                                                                                                                                                                                                                                                                                                                                                                                                                                 \
                         }                                                                                                                                                                                                                                                                                                                                                                                                                                                     \
                     }                                                                                                                                                                                                                                                                                                                                                                                                                                                         \
                 }                                                                                                                                                                                                                                                                                                                                                                                                                                                             \
             };
-    #endif
-#endif
-// Only Callable from within the solver
-#ifdef NO_FINAL_SUM_K
-    #define FINAL_SUM_K( index, ... ) {};
-#else
-    #ifdef BENCH
-        #define FINAL_SUM_K( index, ... )                                                                                                                                                                                                                                                                 \
-            {                                                                                                                                                                                                                                                                                             \
-                Type::uint32 current_halo = system.p.halo_size;                                                                                                                                                                                                                                           \
-                auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                             \
-                Solver::InputOutput io{ matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.wavefunction##_iplus.getDevicePtr( subgrid ), matrix.wavefunction##_iminus.getDevicePtr( subgrid ), matrix.reservoir_plus.getDevicePtr( subgrid ),    \
-                                        matrix.reservoir_minus.getDevicePtr( subgrid ),   matrix.wavefunction_plus.getDevicePtr( subgrid ),  matrix.wavefunction_minus.getDevicePtr( subgrid ),   matrix.reservoir_plus.getDevicePtr( subgrid ),        matrix.reservoir_minus.getDevicePtr( subgrid ) }; \
-                Type::complex *k_vec_wf_plus = matrix.k_wavefunction_plus.getDevicePtr( subgrid );                                                                                                                                                                                                        \
-                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                \
-            };
-    #else
-        #define FINAL_SUM_K( index, ... )                                                                                                                                                                                                                                                                                                                                                                                                         \
-            {                                                                                                                                                                                                                                                                                                                                                                                                                                     \
-                Type::uint32 current_halo = system.p.halo_size;                                                                                                                                                                                                                                                                                                                                                                                   \
-                auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                                                                                                                                                                                                     \
-                Solver::InputOutput io{ matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.reservoir_plus.getDevicePtr( subgrid ), matrix.reservoir_minus.getDevicePtr( subgrid ), matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.reservoir_plus.getDevicePtr( subgrid ), matrix.reservoir_minus.getDevicePtr( subgrid ) }; \
-                Type::complex *k_vec_wf_plus = matrix.k_wavefunction_plus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                                \
-                if ( system.use_reservoir ) {                                                                                                                                                                                                                                                                                                                                                                                                     \
-                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                                \
-                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                              \
-                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                  \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                               \
-                        }                                                                                                                                                                                                                                                                                                                                                                                                                         \
-                    } else {                                                                                                                                                                                                                                                                                                                                                                                                                      \
-                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                             \
-                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                  \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                              \
-                        }                                                                                                                                                                                                                                                                                                                                                                                                                         \
-                    }                                                                                                                                                                                                                                                                                                                                                                                                                             \
-                    Type::complex *k_vec_res_plus = matrix.k_reservoir_plus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                              \
-                    if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                    \
-                        CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_plus, k_vec_res_plus );                                                                                                                                                \
-                    } else {                                                                                                                                                                                                                                                                                                                                                                                                                      \
-                        CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_plus, k_vec_res_plus );                                                                                                                                                 \
-                    }                                                                                                                                                                                                                                                                                                                                                                                                                             \
-                    if ( system.use_twin_mode ) {                                                                                                                                                                                                                                                                                                                                                                                                 \
-                        Type::complex *k_vec_wf_minus = matrix.k_wavefunction_minus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                      \
-                        if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                            \
-                            if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                            \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                        \
-                            } else {                                                                                                                                                                                                                                                                                                                                                                                                              \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                         \
-                            }                                                                                                                                                                                                                                                                                                                                                                                                                     \
-                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                  \
-                            if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                            \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                       \
-                            } else {                                                                                                                                                                                                                                                                                                                                                                                                              \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                        \
-                            }                                                                                                                                                                                                                                                                                                                                                                                                                     \
-                        }                                                                                                                                                                                                                                                                                                                                                                                                                         \
-                        Type::complex *k_vec_res_minus = matrix.k_reservoir_minus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                        \
-                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_minus, k_vec_res_minus );                                                                                                                                          \
-                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                  \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, true, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_rv_minus, k_vec_res_minus );                                                                                                                                           \
-                        }                                                                                                                                                                                                                                                                                                                                                                                                                         \
-                    }                                                                                                                                                                                                                                                                                                                                                                                                                             \
-                } else {                                                                                                                                                                                                                                                                                                                                                                                                                          \
-                    if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                                \
-                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                             \
-                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                  \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                              \
-                        }                                                                                                                                                                                                                                                                                                                                                                                                                         \
-                    } else {                                                                                                                                                                                                                                                                                                                                                                                                                      \
-                        if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                                \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                            \
-                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                  \
-                            CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_plus, k_vec_wf_plus );                                                                                                                                             \
-                        }                                                                                                                                                                                                                                                                                                                                                                                                                         \
-                    }                                                                                                                                                                                                                                                                                                                                                                                                                             \
-                    if ( system.use_twin_mode ) {                                                                                                                                                                                                                                                                                                                                                                                                 \
-                        Type::complex *k_vec_wf_minus = matrix.k_wavefunction_minus.getDevicePtr( subgrid );                                                                                                                                                                                                                                                                                                                                      \
-                        if ( system.use_stochastic ) {                                                                                                                                                                                                                                                                                                                                                                                            \
-                            if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                            \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                       \
-                            } else {                                                                                                                                                                                                                                                                                                                                                                                                              \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                        \
-                            }                                                                                                                                                                                                                                                                                                                                                                                                                     \
-                        } else {                                                                                                                                                                                                                                                                                                                                                                                                                  \
-                            if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                                                                                                                                                                                            \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                      \
-                            } else {                                                                                                                                                                                                                                                                                                                                                                                                              \
-                                CALL_SUBGRID_KERNEL( Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, false, false, index, __VA_ARGS__ )>, "Sum for K" #index, current_grid, current_block, stream, current_halo, kernel_arguments, io.in_wf_minus, k_vec_wf_minus );                                                                                                                                       \
-                            }                                                                                                                                                                                                                                                                                                                                                                                                                     \
-                        }                                                                                                                                                                                                                                                                                                                                                                                                                         \
-                    }                                                                                                                                                                                                                                                                                                                                                                                                                             \
-                }                                                                                                                                                                                                                                                                                                                                                                                                                                 \
-            };
 
     #endif
 #endif
+// The reservoir is only updated if evolve_reservoir is true.
+#define FINAL_SUM_K( index, ... ) FINAL_SUM_K_RESERVOIR( index, true, __VA_ARGS__ )
 
+// The error estimate is only valid on the inner subgrid, so it is evaluated without halo. The halo of rk_error stays zero.
 #define ERROR_K( order, ... )                                                                                                                                                                                                                             \
     {                                                                                                                                                                                                                                                     \
-        Type::uint32 current_halo = system.p.halo_size;                                                                                                                                                                                                   \
+        Type::uint32 current_halo = 0;                                                                                                                                                                                                                    \
         auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );                                                                                                     \
         Type::complex *k_vec_wf_plus = matrix.k_wavefunction_plus.getDevicePtr( subgrid );                                                                                                                                                                \
         if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                        \
@@ -576,7 +646,7 @@
             CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_error<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, true, true, __VA_ARGS__ )>, "Sum for Error", current_grid, current_block, stream, current_halo, kernel_arguments, k_vec_wf_plus );        \
         }                                                                                                                                                                                                                                                 \
         if ( system.use_twin_mode ) {                                                                                                                                                                                                                     \
-            Type::complex *k_vec_wf_minus = matrix.k_wavefunction_plus.getDevicePtr( subgrid );                                                                                                                                                           \
+            Type::complex *k_vec_wf_minus = matrix.k_wavefunction_minus.getDevicePtr( subgrid );                                                                                                                                                            \
             if ( system.imag_time_amplitude == 0.0 ) {                                                                                                                                                                                                    \
                 CALL_SUBGRID_KERNEL( Kernel::Summation::runge_sum_to_error<GCC_EXPAND_VA_ARGS_ORDER( Type::complex, false, false, __VA_ARGS__ )>, "Sum for Error", current_grid, current_block, stream, current_halo, kernel_arguments, k_vec_wf_minus ); \
             } else {                                                                                                                                                                                                                                      \
@@ -586,16 +656,42 @@
     };
 
 // Only Callable from within the solver
-// For now, use this macro to synchronize the halos. This is a bit of a mess, but it works. TODO: move halo_map to static CUDAMatrix vector and call synchronize_halos from there.
+// Synchronizes the halos row by row from the halo rectangles of the matrix container, see Kernel::Halo::HaloRectangle.
+// The boundary conditions are dispatched to the compile time specializations of the kernels.
+// SYNCHRONIZE_HALOS_NOWAIT shares the synchronization among the threads of an enclosing parallel region on the CPU.
 #ifdef NO_HALO_SYNC
     #define SYNCHRONIZE_HALOS( _stream, subgrids ) \
         {}
+    #define SYNCHRONIZE_HALOS_NOWAIT( _stream, subgrids ) \
+        {}
+    #define SYNCHRONIZE_HALOS_INTERPOLATED( _stream, subgrids, previous_subgrids ) \
+        {}
 #else
-    #define SYNCHRONIZE_HALOS( _stream, subgrids )                                                                                                                                                                                                                                                                                                               \
-        {                                                                                                                                                                                                                                                                                                                                                        \
-            Type::uint32 halo_map_size = matrix.halo_map.size() / 6;                                                                                                                                                                                                                                                                                             \
-            auto [current_block, current_grid] = getLaunchParameters( halo_map_size * system.p.subgrids_columns * system.p.subgrids_rows );                                                                                                                                                                                                                      \
-            CALL_FULL_KERNEL( Kernel::Halo::synchronize_halos, "Synchronization", current_grid, current_block, _stream, system.p.subgrids_columns, system.p.subgrids_rows, system.p.subgrid_N_c, system.p.subgrid_N_r, system.p.halo_size, halo_map_size, system.p.periodic_boundary_x, system.p.periodic_boundary_y, GET_RAW_PTR( matrix.halo_map ), subgrids ) \
+    #define SYNCHRONIZE_HALOS_DISPATCH( call, kernel, _stream, ... )                                                                                                                                                                                                           \
+        if ( system.p.periodic_boundary_x and system.p.periodic_boundary_y ) {                                                                                                                                                                                                 \
+            call( kernel<GCC_EXPAND_VA_ARGS( true, true )>, "Synchronization", current_grid, current_block, _stream, system.p.subgrids_columns, system.p.subgrids_rows, system.p.subgrid_row_offset, matrix.halo_rows, GET_RAW_PTR( matrix.halo_rectangles ), __VA_ARGS__ );   \
+        } else if ( system.p.periodic_boundary_x ) {                                                                                                                                                                                                                           \
+            call( kernel<GCC_EXPAND_VA_ARGS( true, false )>, "Synchronization", current_grid, current_block, _stream, system.p.subgrids_columns, system.p.subgrids_rows, system.p.subgrid_row_offset, matrix.halo_rows, GET_RAW_PTR( matrix.halo_rectangles ), __VA_ARGS__ );  \
+        } else if ( system.p.periodic_boundary_y ) {                                                                                                                                                                                                                           \
+            call( kernel<GCC_EXPAND_VA_ARGS( false, true )>, "Synchronization", current_grid, current_block, _stream, system.p.subgrids_columns, system.p.subgrids_rows, system.p.subgrid_row_offset, matrix.halo_rows, GET_RAW_PTR( matrix.halo_rectangles ), __VA_ARGS__ );  \
+        } else {                                                                                                                                                                                                                                                               \
+            call( kernel<GCC_EXPAND_VA_ARGS( false, false )>, "Synchronization", current_grid, current_block, _stream, system.p.subgrids_columns, system.p.subgrids_rows, system.p.subgrid_row_offset, matrix.halo_rows, GET_RAW_PTR( matrix.halo_rectangles ), __VA_ARGS__ ); \
+        }
+    #define SYNCHRONIZE_HALOS( _stream, subgrids )                                                                                             \
+        {                                                                                                                                      \
+            auto [current_block, current_grid] = getLaunchParameters( matrix.halo_rows * system.p.subgrids_columns * system.p.subgrids_rows ); \
+            SYNCHRONIZE_HALOS_DISPATCH( CALL_FULL_KERNEL, Kernel::Halo::synchronize_halos, _stream, subgrids )                                 \
+        }
+    #define SYNCHRONIZE_HALOS_NOWAIT( _stream, subgrids )                                                                                      \
+        {                                                                                                                                      \
+            auto [current_block, current_grid] = getLaunchParameters( matrix.halo_rows * system.p.subgrids_columns * system.p.subgrids_rows ); \
+            SYNCHRONIZE_HALOS_DISPATCH( CALL_FULL_KERNEL_NOWAIT, Kernel::Halo::synchronize_halos, _stream, subgrids )                          \
+        }
+    // Synchronizes the halos of the subgrids that start a local time step, see synchronize_halos_interpolated.
+    #define SYNCHRONIZE_HALOS_INTERPOLATED( _stream, subgrids, previous_subgrids )                                                                                                                                              \
+        {                                                                                                                                                                                                                       \
+            auto [current_block, current_grid] = getLaunchParameters( matrix.halo_rows * system.p.subgrids_columns * system.p.subgrids_rows );                                                                                  \
+            SYNCHRONIZE_HALOS_DISPATCH( CALL_FULL_KERNEL, Kernel::Halo::synchronize_halos_interpolated, _stream, subgrids, previous_subgrids, GET_RAW_PTR( local_timestep_halo_weight ), GET_RAW_PTR( local_timestep_active ) ) \
         }
 #endif
 // Helper to retrieve the raw device pointer. When using nvcc and thrust, we need a raw pointer cast.
@@ -638,56 +734,70 @@
     #define CALL_FULL_KERNEL( func, name, grid, block, stream, ... ) \
         { func<<<grid, block, 0, stream>>>( 0, __VA_ARGS__ ); }
     // Wraps the successive calls to the CUDA Kernels into a single CUDA Graph.
+    // A subcycled reservoir is held fixed within its cycle and synchronized once per cycle instead, see beginReservoirCycle().
     // Edit: Oh God what a mess.
-    #define SOLVER_SEQUENCE( with_graph, content )                                                                                                                                                                 \
-        {                                                                                                                                                                                                          \
-            static bool cuda_graph_created = false;                                                                                                                                                                \
-            static cudaGraph_t graph;                                                                                                                                                                              \
-            static cudaGraphExec_t instance;                                                                                                                                                                       \
-            static cudaStream_t stream;                                                                                                                                                                            \
-            static cudaGraphNode_t *nodes;                                                                                                                                                                         \
-            static size_t num_nodes;                                                                                                                                                                               \
-            if ( not cuda_graph_created or not with_graph ) {                                                                                                                                                      \
-                std::vector<Solver::KernelArguments> v_kernel_arguments;                                                                                                                                           \
-                for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {                                                                                        \
-                    v_kernel_arguments.push_back( generateKernelArguments( subgrid ) );                                                                                                                            \
-                }                                                                                                                                                                                                  \
-                if ( with_graph ) {                                                                                                                                                                                \
-                    cudaStreamCreate( &stream );                                                                                                                                                                   \
-                    cudaStreamBeginCapture( stream, cudaStreamCaptureModeGlobal );                                                                                                                                 \
-                    std::cout << PHOENIX::CLIO::prettyPrint( "Capturing CUDA Graph", PHOENIX::CLIO::Control::Secondary | PHOENIX::CLIO::Control::Info ) << std::endl;                                              \
-                }                                                                                                                                                                                                  \
-                if ( system.use_twin_mode ) {                                                                                                                                                                      \
-                    SYNCHRONIZE_HALOS( stream, matrix.wavefunction_plus.getSubgridDevicePtrs() );                                                                                                                  \
-                    SYNCHRONIZE_HALOS( stream, matrix.wavefunction_minus.getSubgridDevicePtrs() );                                                                                                                 \
-                    if ( system.use_reservoir ) {                                                                                                                                                                  \
-                        SYNCHRONIZE_HALOS( stream, matrix.reservoir_plus.getSubgridDevicePtrs() );                                                                                                                 \
-                        SYNCHRONIZE_HALOS( stream, matrix.reservoir_minus.getSubgridDevicePtrs() );                                                                                                                \
-                    }                                                                                                                                                                                              \
-                } else {                                                                                                                                                                                           \
-                    SYNCHRONIZE_HALOS( stream, matrix.wavefunction_plus.getSubgridDevicePtrs() );                                                                                                                  \
-                    if ( system.use_reservoir ) {                                                                                                                                                                  \
-                        SYNCHRONIZE_HALOS( stream, matrix.reservoir_plus.getSubgridDevicePtrs() );                                                                                                                 \
-                    }                                                                                                                                                                                              \
-                }                                                                                                                                                                                                  \
-                for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {                                                                                        \
-                    auto &kernel_arguments = v_kernel_arguments[subgrid];                                                                                                                                          \
-                    content;                                                                                                                                                                                       \
-                }                                                                                                                                                                                                  \
-                if ( with_graph ) {                                                                                                                                                                                \
-                    cudaStreamEndCapture( stream, &graph );                                                                                                                                                        \
-                    cudaGraphInstantiate( &instance, graph, NULL, NULL, 0 );                                                                                                                                       \
-                    cuda_graph_created = true;                                                                                                                                                                     \
-                    cudaGraphGetNodes( graph, nullptr, &num_nodes );                                                                                                                                               \
-                    nodes = new cudaGraphNode_t[num_nodes];                                                                                                                                                        \
-                    cudaGraphGetNodes( graph, nodes, &num_nodes );                                                                                                                                                 \
-                    std::cout << PHOENIX::CLIO::prettyPrint( "CUDA Graph created with " + std::to_string( num_nodes ) + " nodes", PHOENIX::CLIO::Control::Secondary | PHOENIX::CLIO::Control::Info ) << std::endl; \
-                }                                                                                                                                                                                                  \
-            } else {                                                                                                                                                                                               \
-                cudaGraphLaunch( instance, stream );                                                                                                                                                               \
-            }                                                                                                                                                                                                      \
+    #define SOLVER_SEQUENCE( with_graph, content )                                                                                                                                                                                                    \
+        {                                                                                                                                                                                                                                             \
+            static bool cuda_graph_created = false;                                                                                                                                                                                                   \
+            static cudaGraph_t graph;                                                                                                                                                                                                                 \
+            static cudaGraphExec_t instance;                                                                                                                                                                                                          \
+            static cudaStream_t stream;                                                                                                                                                                                                               \
+            static cudaGraphNode_t *nodes;                                                                                                                                                                                                            \
+            static size_t num_nodes;                                                                                                                                                                                                                  \
+            if ( not cuda_graph_created or not with_graph ) {                                                                                                                                                                                         \
+                std::vector<Solver::KernelArguments> v_kernel_arguments;                                                                                                                                                                              \
+                for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {                                                                                                                           \
+                    v_kernel_arguments.push_back( generateKernelArguments( subgrid ) );                                                                                                                                                               \
+                }                                                                                                                                                                                                                                     \
+                if ( with_graph ) {                                                                                                                                                                                                                   \
+                    cudaStreamCreate( &stream );                                                                                                                                                                                                      \
+                    cudaStreamBeginCapture( stream, cudaStreamCaptureModeGlobal );                                                                                                                                                                    \
+                    std::cout << PHOENIX::CLIO::prettyPrint( "Capturing CUDA Graph", PHOENIX::CLIO::Control::Secondary | PHOENIX::CLIO::Control::Info ) << std::endl;                                                                                 \
+                }                                                                                                                                                                                                                                     \
+                if ( system.use_twin_mode ) {                                                                                                                                                                                                         \
+                    SYNCHRONIZE_HALOS( stream, matrix.wavefunction_plus.getSubgridDevicePtrs() );                                                                                                                                                     \
+                    SYNCHRONIZE_HALOS( stream, matrix.wavefunction_minus.getSubgridDevicePtrs() );                                                                                                                                                    \
+                    if ( system.use_reservoir and system.reservoir_subcycle == 1 ) {                                                                                                                                                                  \
+                        SYNCHRONIZE_HALOS( stream, matrix.reservoir_plus.getSubgridDevicePtrs() );                                                                                                                                                    \
+                        SYNCHRONIZE_HALOS( stream, matrix.reservoir_minus.getSubgridDevicePtrs() );                                                                                                                                                   \
+                    }                                                                                                                                                                                                                                 \
+                } else {                                                                                                                                                                                                                              \
+                    SYNCHRONIZE_HALOS( stream, matrix.wavefunction_plus.getSubgridDevicePtrs() );                                                                                                                                                     \
+                    if ( system.use_reservoir and system.reservoir_subcycle == 1 ) {                                                                                                                                                                  \
+                        SYNCHRONIZE_HALOS( stream, matrix.reservoir_plus.getSubgridDevicePtrs() );                                                                                                                                                    \
+                    }                                                                                                                                                                                                                                 \
+                }                                                                                                                                                                                                                                     \
+                for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {                                                                                                                           \
+                    auto &kernel_arguments = v_kernel_arguments[subgrid];                                                                                                                                                                             \
+                    content;                                                                                                                                                                                                                          \
+                }                                                                                                                                                                                                                                     \
+                if ( with_graph ) {                                                                                                                                                                                                                   \
+                    cudaStreamEndCapture( stream, &graph );                                                                                                                                                                                           \
+                    cudaGraphInstantiate( &instance, graph, NULL, NULL, 0 );                                                                                                                                                                          \
+                    cuda_graph_created = true;                                                                                                                                                                                                        \
+                    cudaGraphGetNodes( graph, nullptr, &num_nodes );                                                                                                                                                                                  \
+                    nodes = new cudaGraphNode_t[num_nodes];                                                                                                                                                                                           \
+                    cudaGraphGetNodes( graph, nodes, &num_nodes );                                                                                                                                                                                    \
+                    std::cout << PHOENIX::CLIO::prettyPrint( "CUDA Graph created with " + std::to_string( num_nodes ) + " nodes", PHOENIX::CLIO::Control::Secondary | PHOENIX::CLIO::Control::Info ) << std::endl;                                    \
+                }                                                                                                                                                                                                                                     \
+            } else {                                                                                                                                                                                                                                  \
+                cudaGraphLaunch( instance, stream );                                                                                                                                                                                                  \
+            }                                                                                                                                                                                                                                         \
+        }
+
+    // Runs the content for every subgrid like SOLVER_SEQUENCE, but without synchronizing the halos and without a CUDA graph.
+    // Used by the steps that evaluate the halo left from the last exchange, see --haloDepth.
+    #define SUBGRID_SEQUENCE( content )                                                                                 \
+        {                                                                                                               \
+            cudaStream_t stream = 0;                                                                                    \
+            for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) { \
+                auto kernel_arguments = generateKernelArguments( subgrid );                                             \
+                content;                                                                                                \
+            }                                                                                                           \
         }
 
+    // The halo synchronization is part of the CUDA graph, so the final content simply follows the content.
+    #define OVERLAPPED_SOLVER_SEQUENCE( with_graph, content, final_content ) SOLVER_SEQUENCE( with_graph, content; final_content; )
 #else
     // On the CPU, the check for CUDA errors does nothing
     #define CHECK_CUDA_ERROR( func, msg )
@@ -696,17 +806,33 @@
 
     // CALL_SUBGRID_KERNEL will call the kernel row-wise, making sure that memory accesses are coalesced and the innermost loop is vectorizable
     // CALL_FULL_KERNEL will also handle the indexing, making sure that the function is called with the correct, modified row-col index depending on the current halo.
-    #define CALL_SUBGRID_KERNEL( func, name, grid, block, stream, ... )                             \
-        {                                                                                           \
-            const int halo_rem = system.p.halo_size - current_halo;                                 \
-            const int nc = system.p.subgrid_N_c;                                                    \
-            const int bx = block.x;                                                                 \
-            for ( int row = 0; row < bx; row++ ) {                                                  \
-                int index_start = ( row + halo_rem ) * system.p.subgrid_row_offset + halo_rem;      \
-                _Pragma( "omp simd" ) for ( int col = 0; col < nc + 2 * ( current_halo ); col++ ) { \
-                    func( index_start + col, __VA_ARGS__ );                                         \
-                }                                                                                   \
-            }                                                                                       \
+    #define CALL_SUBGRID_KERNEL( func, name, grid, block, stream, ... )                                      \
+        {                                                                                                    \
+            const int halo_rem = system.p.halo_size - current_halo;                                          \
+            const int nc = system.p.subgrid_N_c;                                                             \
+            const int bx = block.x;                                                                          \
+            const int width = nc + 2 * ( current_halo );                                                     \
+            const int inset = system.p.halo_size;                                                            \
+            const bool has_interior = bx > 2 * inset and width > 2 * inset;                                  \
+            const auto region = kernel_arguments.region;                                                     \
+            /* Every row is split into two spans, such that the border can leave out the interior columns */ \
+            for ( int span = 0; span < 2 * bx; span++ ) {                                                    \
+                const int row = span / 2;                                                                    \
+                const bool interior_row = has_interior and row >= inset and row < bx - inset;                \
+                int col_begin = span % 2 == 0 ? 0 : width;                                                   \
+                int col_end = width;                                                                         \
+                if ( region == Solver::SubgridRegion::Interior ) {                                           \
+                    col_begin = interior_row and span % 2 == 0 ? inset : 0;                                  \
+                    col_end = interior_row and span % 2 == 0 ? width - inset : 0;                            \
+                } else if ( region == Solver::SubgridRegion::Border and interior_row ) {                     \
+                    col_begin = span % 2 == 0 ? 0 : width - inset;                                           \
+                    col_end = span % 2 == 0 ? inset : width;                                                 \
+                }                                                                                            \
+                int index_start = ( row + halo_rem ) * system.p.subgrid_row_offset + halo_rem;               \
+                _Pragma( "omp simd" ) for ( int col = col_begin; col < col_end; col++ ) {                    \
+                    func( index_start + col, __VA_ARGS__ );                                                  \
+                }                                                                                            \
+            }                                                                                                \
         }
     #ifdef BENCH
         #ifdef AVX2
@@ -742,38 +868,105 @@
                 func( i, __VA_ARGS__ );                                                                           \
             }                                                                                                     \
         }
+    // Shares the kernel among the threads of an enclosing parallel region without waiting for them at its end.
+    #define CALL_FULL_KERNEL_NOWAIT( func, name, grid, block, stream, ... )                                     \
+        {                                                                                                       \
+            const Type::uint32 execution_range = block.x * grid.x;                                              \
+            _Pragma( "omp for schedule(static) nowait" ) for ( Type::uint32 i = 0; i < execution_range; ++i ) { \
+                func( i, __VA_ARGS__ );                                                                         \
+            }                                                                                                   \
+        }
     // Merges the Kernel calls into a single function call. This is not required on the CPU.
-    #define SOLVER_SEQUENCE( with_graph, content )                                                                                                                     \
+    // A subcycled reservoir is held fixed within its cycle and synchronized once per cycle instead, see beginReservoirCycle().
+    // The kernel arguments of the subgrids are generated on first use and cached by the solver, see Solver::solver_sequence_arguments.
+    #define SOLVER_SEQUENCE( with_graph, content )                                                                                                                                                        \
+        {                                                                                                                                                                                                 \
+            PHOENIX::Type::stream_t stream;                                                                                                                                                               \
+            Type::uint32 current_halo = system.p.halo_size;                                                                                                                                               \
+            if ( solver_sequence_arguments.empty() ) {                                                                                                                                                    \
+                for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {                                                                               \
+                    solver_sequence_arguments.push_back( generateKernelArguments( subgrid ) );                                                                                                            \
+                }                                                                                                                                                                                         \
+            }                                                                                                                                                                                             \
+            if ( system.use_twin_mode ) {                                                                                                                                                                 \
+                SYNCHRONIZE_HALOS( stream, matrix.wavefunction_plus.getSubgridDevicePtrs() )                                                                                                              \
+                SYNCHRONIZE_HALOS( stream, matrix.wavefunction_minus.getSubgridDevicePtrs() )                                                                                                             \
+                if ( system.use_reservoir and system.reservoir_subcycle == 1 ) {                                                                                                                          \
+                    SYNCHRONIZE_HALOS( stream, matrix.reservoir_plus.getSubgridDevicePtrs() )                                                                                                             \
+                    SYNCHRONIZE_HALOS( stream, matrix.reservoir_minus.getSubgridDevicePtrs() )                                                                                                            \
+                }                                                                                                                                                                                         \
+            } else {                                                                                                                                                                                      \
+                SYNCHRONIZE_HALOS( stream, matrix.wavefunction_plus.getSubgridDevicePtrs() )                                                                                                              \
+                if ( system.use_reservoir and system.reservoir_subcycle == 1 ) {                                                                                                                          \
+                    SYNCHRONIZE_HALOS( stream, matrix.reservoir_plus.getSubgridDevicePtrs() )                                                                                                             \
+                }                                                                                                                                                                                         \
+            }                                                                                                                                                                                             \
+            _Pragma( "omp parallel for schedule(static)" ) for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {                                    \
+                PHOENIX_NUMA_INSERT;                                                                                                                                                                      \
+                auto &kernel_arguments = solver_sequence_arguments[subgrid];                                                                                                                              \
+                content;                                                                                                                                                                                  \
+            }                                                                                                                                                                                             \
+        }
+
+    // Runs the content for every subgrid like SOLVER_SEQUENCE, but without synchronizing the halos, see --haloDepth.
+    #define SUBGRID_SEQUENCE( content )                                                                                                                                \
         {                                                                                                                                                              \
             PHOENIX::Type::stream_t stream;                                                                                                                            \
-            static bool first_time = false;                                                                                                                            \
-            static std::vector<Solver::KernelArguments> v_kernel_arguments;                                                                                            \
-            Type::uint32 current_halo = system.p.halo_size;                                                                                                            \
-            if ( not first_time ) {                                                                                                                                    \
+            if ( solver_sequence_arguments.empty() ) {                                                                                                                 \
                 for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {                                            \
-                    v_kernel_arguments.push_back( generateKernelArguments( subgrid ) );                                                                                \
-                }                                                                                                                                                      \
-                first_time = true;                                                                                                                                     \
-            }                                                                                                                                                          \
-            if ( system.use_twin_mode ) {                                                                                                                              \
-                SYNCHRONIZE_HALOS( stream, matrix.wavefunction_plus.getSubgridDevicePtrs() )                                                                           \
-                SYNCHRONIZE_HALOS( stream, matrix.wavefunction_minus.getSubgridDevicePtrs() )                                                                          \
-                if ( system.use_reservoir ) {                                                                                                                          \
-                    SYNCHRONIZE_HALOS( stream, matrix.reservoir_plus.getSubgridDevicePtrs() )                                                                          \
-                    SYNCHRONIZE_HALOS( stream, matrix.reservoir_minus.getSubgridDevicePtrs() )                                                                         \
-                }                                                                                                                                                      \
-            } else {                                                                                                                                                   \
-                SYNCHRONIZE_HALOS( stream, matrix.wavefunction_plus.getSubgridDevicePtrs() )                                                                           \
-                if ( system.use_reservoir ) {                                                                                                                          \
-                    SYNCHRONIZE_HALOS( stream, matrix.reservoir_plus.getSubgridDevicePtrs() )                                                                          \
+                    solver_sequence_arguments.push_back( generateKernelArguments( subgrid ) );                                                                         \
                 }                                                                                                                                                      \
             }                                                                                                                                                          \
             _Pragma( "omp parallel for schedule(static)" ) for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) { \
                 PHOENIX_NUMA_INSERT;                                                                                                                                   \
-                auto &kernel_arguments = v_kernel_arguments[subgrid];                                                                                                  \
+                auto &kernel_arguments = solver_sequence_arguments[subgrid];                                                                                           \
                 content;                                                                                                                                               \
             }                                                                                                                                                          \
         }
+
+    // Runs the content and then the final content like SOLVER_SEQUENCE, but overlaps the halo synchronization with the
+    // content on the interior of the subgrids, see Solver::SubgridRegion. The border of the content follows. The content
+    // must only read the halo through the shrinking halo of its kernels, and must neither write the synchronized matrices
+    // nor overwrite its own inputs. The final content is evaluated on the full subgrids.
+    #define OVERLAPPED_SOLVER_SEQUENCE( with_graph, content, final_content )                                                                                                               \
+        {                                                                                                                                                                                  \
+            PHOENIX::Type::stream_t stream;                                                                                                                                                \
+            if ( solver_sequence_arguments.empty() ) {                                                                                                                                     \
+                for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {                                                                \
+                    solver_sequence_arguments.push_back( generateKernelArguments( subgrid ) );                                                                                             \
+                }                                                                                                                                                                          \
+            }                                                                                                                                                                              \
+            _Pragma( "omp parallel" ) {                                                                                                                                                    \
+                if ( system.use_twin_mode ) {                                                                                                                                              \
+                    SYNCHRONIZE_HALOS_NOWAIT( stream, matrix.wavefunction_plus.getSubgridDevicePtrs() )                                                                                    \
+                    SYNCHRONIZE_HALOS_NOWAIT( stream, matrix.wavefunction_minus.getSubgridDevicePtrs() )                                                                                   \
+                    if ( system.use_reservoir and system.reservoir_subcycle == 1 ) {                                                                                                       \
+                        SYNCHRONIZE_HALOS_NOWAIT( stream, matrix.reservoir_plus.getSubgridDevicePtrs() )                                                                                   \
+                        SYNCHRONIZE_HALOS_NOWAIT( stream, matrix.reservoir_minus.getSubgridDevicePtrs() )                                                                                  \
+                    }                                                                                                                                                                      \
+                } else {                                                                                                                                                                   \
+                    SYNCHRONIZE_HALOS_NOWAIT( stream, matrix.wavefunction_plus.getSubgridDevicePtrs() )                                                                                    \
+                    if ( system.use_reservoir and system.reservoir_subcycle == 1 ) {                                                                                                       \
+                        SYNCHRONIZE_HALOS_NOWAIT( stream, matrix.reservoir_plus.getSubgridDevicePtrs() )                                                                                   \
+                    }                                                                                                                                                                      \
+                }                                                                                                                                                                          \
+                _Pragma( "omp for schedule(static) nowait" ) for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {                   \
+                    PHOENIX_NUMA_INSERT;                                                                                                                                                   \
+                    auto &kernel_arguments = solver_sequence_arguments[subgrid];                                                                                                           \
+                    kernel_arguments.region = Solver::SubgridRegion::Interior;                                                                                                             \
+                    content;                                                                                                                                                               \
+                }                                                                                                                                                                          \
+                /* The halos are complete, and the neighbours have read the border of every subgrid */                                                                                     \
+                _Pragma( "omp barrier" ) _Pragma( "omp for schedule(static)" ) for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) { \
+                    PHOENIX_NUMA_INSERT;                                                                                                                                                   \
+                    auto &kernel_arguments = solver_sequence_arguments[subgrid];                                                                                                           \
+                    kernel_arguments.region = Solver::SubgridRegion::Border;                                                                                                               \
+                    content;                                                                                                                                                               \
+                    kernel_arguments.region = Solver::SubgridRegion::Full;                                                                                                                 \
+                    final_content;                                                                                                                                                         \
+                }                                                                                                                                                                          \
+            }                                                                                                                                                                              \
+        }
 #endif
 
 // Swaps symbols a and b
@@ -371,7 +371,7 @@ class CUDAMatrix : CUDAMatrixBase {
         return total_size_host;
     }
 
-    CUDAMatrix<T>& toFull( PHOENIX::Type::device_vector<T>& out, PHOENIX::Type::uint32 matrix = 0, PHOENIX::Type::stream_t stream = 0 ) {
+    CUDAMatrix<T>& toFull( T* fullgrid_dev_ptr, PHOENIX::Type::uint32 matrix = 0, PHOENIX::Type::stream_t stream = 0 ) {
         if ( not is_constructed )
             return *this;
 // Copy all device data to a device buffer.
@@ -384,7 +384,6 @@ class CUDAMatrix : CUDAMatrixBase {
         dim3 block_size( 256, 1 );
         dim3 grid_size( ( rows * cols + block_size.x ) / block_size.x, 1 );
 #endif
-        auto fullgrid_dev_ptr = GET_RAW_PTR( out );
         auto dev_ptrs = getSubgridDevicePtrs( matrix );
         if ( global_matrix_transfer_log )
             std::cout << PHOENIX::CLIO::prettyPrint( "Copying " + std::to_string( subgrids_columns ) + "x" + std::to_string( subgrids_rows ) + " subgrids to full grid buffer for matrix '" + name + "' (" + std::to_string( matrix ) + ")", PHOENIX::CLIO::Control::Info | PHOENIX::CLIO::Control::Secondary ) << std::endl;
@@ -393,6 +392,10 @@ class CUDAMatrix : CUDAMatrixBase {
         return *this;
     }
 
+    CUDAMatrix<T>& toFull( PHOENIX::Type::device_vector<T>& out, PHOENIX::Type::uint32 matrix = 0, PHOENIX::Type::stream_t stream = 0 ) {
+        return toFull( GET_RAW_PTR( out ), matrix, stream );
+    }
+
     CUDAMatrix<T>& toFull( PHOENIX::Type::uint32 matrix = 0, PHOENIX::Type::stream_t stream = 0 ) {
         // Copy all device data to the full static device_data_full buffer
         // This function will copy the data within the respective halos, if they exist,
@@ -401,7 +404,7 @@ class CUDAMatrix : CUDAMatrixBase {
         return *this;
     }
 
-    CUDAMatrix<T>& toSubgrids( PHOENIX::Type::device_vector<T>& in, PHOENIX::Type::uint32 matrix = 0, PHOENIX::Type::stream_t stream = 0 ) {
+    CUDAMatrix<T>& toSubgrids( T* fullgrid_dev_ptr, PHOENIX::Type::uint32 matrix = 0, PHOENIX::Type::stream_t stream = 0 ) {
         if ( not is_constructed )
             return *this;
 // Copy all device data of a device_vector to the subgrids.
@@ -415,7 +418,6 @@ class CUDAMatrix : CUDAMatrixBase {
         dim3 grid_size( ( rows * cols + block_size.x ) / block_size.x, 1 );
 #endif
 
-        auto fullgrid_dev_ptr = GET_RAW_PTR( in );
         auto dev_ptrs = getSubgridDevicePtrs( matrix );
         if ( global_matrix_transfer_log )
             std::cout << PHOENIX::CLIO::prettyPrint( "Copying full grid buffer to subgrids for matrix '" + name + "' (" + std::to_string( matrix ) + ")", PHOENIX::CLIO::Control::Info | PHOENIX::CLIO::Control::Secondary ) << std::endl;
@@ -424,6 +426,10 @@ class CUDAMatrix : CUDAMatrixBase {
         return *this;
     }
 
+    CUDAMatrix<T>& toSubgrids( PHOENIX::Type::device_vector<T>& in, PHOENIX::Type::uint32 matrix = 0, PHOENIX::Type::stream_t stream = 0 ) {
+        return toSubgrids( GET_RAW_PTR( in ), matrix, stream );
+    }
+
     CUDAMatrix<T>& toSubgrids( PHOENIX::Type::uint32 matrix = 0, PHOENIX::Type::stream_t stream = 0 ) {
         // Copy all device data of the full static device_data_full buffer
         // This function will copy the data within the full matrix to the respective subgrid
@@ -615,6 +621,58 @@ class CUDAMatrix : CUDAMatrixBase {
         return std::make_tuple( min, max );
     }
 
+    /**
+     * Transforms the device data to real numbers using a lambda function and returns their maximum.
+     * On the CPU, every subgrid is reduced by all threads using an OpenMP max reduction.
+     * This function does not change the device data.
+     * @param func: Lambda function that takes a T and returns a Type::real.
+    */
+    template <typename Func>
+    Type::real transformMax( Func func ) {
+        Type::real result = 0.0;
+#ifdef USE_CPU
+        for ( int i = 0; i < total_num_subgrids; i++ ) {
+            const T* data = GET_RAW_PTR( device_data[i] );
+            const Type::uint32 size = device_data[i].size();
+    #pragma omp parallel for schedule( static ) reduction( max : result )
+            for ( Type::uint32 j = 0; j < size; j++ ) {
+                result = std::max( result, func( data[j] ) );
+            }
+        }
+#else
+        for ( int i = 0; i < total_num_subgrids; i++ ) {
+            result = std::max( result, thrust::transform_reduce( device_data[i].begin(), device_data[i].end(), func, Type::real( 0.0 ), thrust::maximum<Type::real>() ) );
+        }
+#endif
+        return result;
+    }
+
+    /**
+     * Transforms the device data to real numbers using a lambda function and returns the maximum of every subgrid,
+     * including its halo. On the CPU, the subgrids are reduced in parallel.
+     * This function does not change the device data.
+     * @param func: Lambda function that takes a T and returns a Type::real.
+    */
+    template <typename Func>
+    std::vector<Type::real> transformMaxPerSubgrid( Func func ) {
+        std::vector<Type::real> result( total_num_subgrids, 0.0 );
+#ifdef USE_CPU
+    #pragma omp parallel for schedule( static )
+        for ( int i = 0; i < total_num_subgrids; i++ ) {
+            const T* data = GET_RAW_PTR( device_data[i] );
+            const Type::uint32 size = device_data[i].size();
+            for ( Type::uint32 j = 0; j < size; j++ ) {
+                result[i] = std::max( result[i], func( data[j] ) );
+            }
+        }
+#else
+        for ( int i = 0; i < total_num_subgrids; i++ ) {
+            result[i] = thrust::transform_reduce( device_data[i].begin(), device_data[i].end(), func, Type::real( 0.0 ), thrust::maximum<Type::real>() );
+        }
+#endif
+        return result;
+    }
+
     /**
      * Reduces the device data in the matrix using a lambda function.
      * Transformations happen per subgrid. This function does not change the device data.
@@ -0,0 +1,56 @@
+#pragma once
+#include "cuda/typedef.cuh"
+#include "cuda/cuda_macro.cuh"
+#include "solver/gpu_solver.hpp"
+
+namespace PHOENIX::Kernel {
+
+/**
+ * One half step of the Peaceman-Rachford ADI scheme for a single line of the full grid. Solves
+ * (1 - tau/2 alpha D_line) out = (1 + tau/2 alpha D_cross) in
+ * where D_line is the second derivative along the line and D_cross the one perpendicular to it.
+ * The tridiagonal system has constant coefficients, so the Thomas algorithm only needs the
+ * precomputed coefficients and works in place on the output line. Periodic lines are solved with
+ * Sherman-Morrison using the precomputed correction vector z. Every thread solves one line.
+ * Elements of line l are at l * line_stride + j * stride, j = 0 ... n-1.
+ */
+template <bool periodic_line, bool periodic_cross>
+PHOENIX_GLOBAL void adi_sweep( int line, Type::complex* in, Type::complex* out, Solver::ADICoefficients coefficients, const Type::complex cross_weight, const Type::uint32 n, const Type::uint32 lines, const Type::uint32 stride, const Type::uint32 line_stride ) {
+    GET_THREAD_INDEX( line, lines );
+
+    const Type::uint32 first = line * line_stride;
+    // The neighbouring lines for the explicit part. For zero boundaries, the values outside the grid are zero.
+    const bool has_previous = line > 0 or periodic_cross;
+    const bool has_next = Type::uint32( line ) + 1 < lines or periodic_cross;
+    const int previous_offset = line > 0 ? -int( line_stride ) : int( ( lines - 1 ) * line_stride );
+    const int next_offset = Type::uint32( line ) + 1 < lines ? int( line_stride ) : -int( ( lines - 1 ) * line_stride );
+
+    // Forward sweep. The explicit right hand side is evaluated on the fly.
+    Type::complex previous_y = 0.0;
+    for ( Type::uint32 j = 0; j < n; j++ ) {
+        const Type::uint32 index = first + j * stride;
+        const Type::complex center = in[index];
+        Type::complex cross = Type::real( -2.0 ) * center;
+        if ( has_previous )
+            cross += in[index + previous_offset];
+        if ( has_next )
+            cross += in[index + next_offset];
+        const Type::complex rhs = center + cross_weight * cross;
+        previous_y = ( rhs - coefficients.off_diagonal * previous_y ) * coefficients.inverse_denominator[j];
+        out[index] = previous_y;
+    }
+    // Back substitution
+    for ( int j = int( n ) - 2; j >= 0; j-- ) {
+        const Type::uint32 index = first + j * stride;
+        out[index] -= coefficients.c_prime[j] * out[index + stride];
+    }
+    if constexpr ( periodic_line ) {
+        // Sherman-Morrison correction for the corner elements
+        const Type::complex factor = ( out[first] + coefficients.corner_ratio * out[first + ( n - 1 ) * stride] ) * coefficients.correction_factor;
+        for ( Type::uint32 j = 0; j < n; j++ ) {
+            out[first + j * stride] -= factor * coefficients.z[j];
+        }
+    }
+}
+
+} // namespace PHOENIX::Kernel
@@ -15,7 +15,57 @@
 
 namespace PHOENIX::Kernel::Compute {
 
-template <bool tmp_use_tetm, bool tmp_use_reservoir, bool tmp_use_pulse, bool tmp_use_pump, bool tmp_use_potential, bool tmp_use_stochastic>
+// Loss rate gamma_r + R |Psi|^2 of the reservoir for a given |Psi|^2
+PHOENIX_DEVICE PHOENIX_INLINE Type::real reservoir_loss_rate( Solver::KernelArguments& args, const Type::real psi_norm ) {
+    Type::real rate = args.p.gamma_r + args.p.R * psi_norm;
+    if ( args.p.stochastic_amplitude > 0.0 )
+        rate -= args.p.R / args.p.dV;
+    return rate;
+}
+
+// Sum of all pumps at i
+PHOENIX_DEVICE PHOENIX_INLINE Type::complex reservoir_pump( Type::uint32 i, Solver::KernelArguments& args, Type::real* pump ) {
+    Type::complex result = 0.0;
+    for ( int k = 0; k < args.pump_pointers.n; k++ ) {
+        PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
+        result += pump[i + offset] * args.pump_pointers.amp[k];
+    }
+    return result;
+}
+
+// Adiabatically eliminated reservoir, the steady state n_R = P / (gamma_r + R |Psi|^2) of the reservoir equation
+PHOENIX_DEVICE PHOENIX_INLINE Type::complex adiabatic_reservoir( Type::uint32 i, Solver::KernelArguments& args, Type::real* pump, const Type::real psi_norm ) {
+    return reservoir_pump( i, args, pump ) / reservoir_loss_rate( args, psi_norm );
+}
+
+/**
+ * Higher order central difference Laplacian for the stencil radii 2 (9-point, 4th order) and 3 (13-point, 6th order).
+ * The second derivative weights are (-1/12, 4/3, -5/2, 4/3, -1/12) and (1/90, -3/20, 3/2, -49/18, 3/2, -3/20, 1/90).
+ * The default 5-point stencil is evaluated directly in gp_scalar.
+ */
+template <Type::uint32 tmp_stencil_radius>
+PHOENIX_DEVICE PHOENIX_INLINE Type::complex higher_order_laplacian( Type::uint32 i, Solver::KernelArguments& args, const Type::complex* wavefunction ) {
+    static_assert( tmp_stencil_radius == 2 or tmp_stencil_radius == 3, "Only the stencil radii 2 and 3 are implemented" );
+    const int row = args.p.subgrid_row_offset;
+    Type::real center_weight;
+    Type::complex horizontal, vertical;
+    if constexpr ( tmp_stencil_radius == 2 ) {
+        center_weight = Type::real( -5.0 / 2.0 );
+        horizontal = Type::real( 4.0 / 3.0 ) * ( wavefunction[i + 1] + wavefunction[i - 1] ) - Type::real( 1.0 / 12.0 ) * ( wavefunction[i + 2] + wavefunction[i - 2] );
+        vertical = Type::real( 4.0 / 3.0 ) * ( wavefunction[i + row] + wavefunction[i - row] ) - Type::real( 1.0 / 12.0 ) * ( wavefunction[i + 2 * row] + wavefunction[i - 2 * row] );
+    } else {
+        center_weight = Type::real( -49.0 / 18.0 );
+        horizontal = Type::real( 3.0 / 2.0 ) * ( wavefunction[i + 1] + wavefunction[i - 1] ) - Type::real( 3.0 / 20.0 ) * ( wavefunction[i + 2] + wavefunction[i - 2] ) + Type::real( 1.0 / 90.0 ) * ( wavefunction[i + 3] + wavefunction[i - 3] );
+        vertical = Type::real( 3.0 / 2.0 ) * ( wavefunction[i + row] + wavefunction[i - row] ) - Type::real( 3.0 / 20.0 ) * ( wavefunction[i + 2 * row] + wavefunction[i - 2 * row] ) + Type::real( 1.0 / 90.0 ) * ( wavefunction[i + 3 * row] + wavefunction[i - 3 * row] );
+    }
+    return center_weight * ( args.p.one_over_dx2 + args.p.one_over_dy2 ) * wavefunction[i] + horizontal * args.p.one_over_dx2 + vertical * args.p.one_over_dy2;
+}
+
+// If tmp_evolve_reservoir is false, the reservoir only enters the coupling and its k is neither evaluated nor stored.
+// If tmp_adiabatic_reservoir is true, no reservoir is stored and its adiabatic steady state is used instead, see --adiabaticReservoir.
+// tmp_stencil_radius selects the finite difference Laplacian of the scalar kernel, see --stencil. For radius 0, the
+// spectral Laplacian of the input has been written to io.out_wf_plus by Solver::spectralLaplacian.
+template <bool tmp_use_tetm, bool tmp_use_reservoir, bool tmp_use_pulse, bool tmp_use_pump, bool tmp_use_potential, bool tmp_use_stochastic, bool tmp_evolve_reservoir = true, bool tmp_adiabatic_reservoir = false, Type::uint32 tmp_stencil_radius = 1>
 PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar( int i, Type::uint32 current_halo, Solver::KernelArguments args, Solver::InputOutput io ) {
     GENERATE_SUBGRID_INDEX( i, current_halo );
 
@@ -58,7 +108,14 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar( int i, Type::uint32 cur
 
         // Hamiltonian
 
-        Type::complex wf_plus = m_eff_scaled * ( m2_over_dx2_p_dy2 * in_wf + ( io.in_wf_plus[i + subgrid_row_offset] + io.in_wf_plus[i - subgrid_row_offset] ) * one_over_dy2 + ( io.in_wf_plus[i + 1] + io.in_wf_plus[i - 1] ) * one_over_dx2 );
+        Type::complex wf_plus;
+        if constexpr ( tmp_stencil_radius == 0 ) {
+            wf_plus = m_eff_scaled * io.out_wf_plus[i];
+        } else if constexpr ( tmp_stencil_radius == 1 ) {
+            wf_plus = m_eff_scaled * ( m2_over_dx2_p_dy2 * in_wf + ( io.in_wf_plus[i + subgrid_row_offset] + io.in_wf_plus[i - subgrid_row_offset] ) * one_over_dy2 + ( io.in_wf_plus[i + 1] + io.in_wf_plus[i - 1] ) * one_over_dx2 );
+        } else {
+            wf_plus = m_eff_scaled * higher_order_laplacian<tmp_stencil_radius>( i, args, io.in_wf_plus );
+        }
         // -i/hbar * H
         //wf_plus = Type::complex( CUDA::imag( wf_plus ), -1.0f * CUDA::real( wf_plus ) ) * one_over_h_bar_s;
         wf_plus = CUDA::mi_conjugate( wf_plus ) * one_over_h_bar_s;
@@ -71,20 +128,27 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar( int i, Type::uint32 cur
             const Type::complex in_rv = io.in_rv_plus[i];
             wf_plus += args.p.one_over_h_bar_s * args.p.g_r * in_rv * in_wf_mi;
             wf_plus += Type::real( 0.5 ) * args.p.R * in_rv * in_wf;
-            Type::complex rv_plus = -( args.p.gamma_r + args.p.R * in_psi_norm ) * in_rv;
 
-            if constexpr ( tmp_use_pump ) {
-                for ( int k = 0; k < args.pump_pointers.n; k++ ) {
-                    PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
-                    rv_plus += args.dev_ptrs.pump_plus[i + offset] * args.pump_pointers.amp[k];
+            if constexpr ( tmp_evolve_reservoir ) {
+                Type::complex rv_plus = -( args.p.gamma_r + args.p.R * in_psi_norm ) * in_rv;
+
+                if constexpr ( tmp_use_pump ) {
+                    for ( int k = 0; k < args.pump_pointers.n; k++ ) {
+                        PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
+                        rv_plus += args.dev_ptrs.pump_plus[i + offset] * args.pump_pointers.amp[k];
+                    }
                 }
-            }
 
-            if constexpr ( tmp_use_stochastic ) {
-                rv_plus += args.p.R * in_rv / args.p.dV;
-            }
+                if constexpr ( tmp_use_stochastic ) {
+                    rv_plus += args.p.R * in_rv / args.p.dV;
+                }
 
-            io.out_rv_plus[i] = rv_plus;
+                io.out_rv_plus[i] = rv_plus;
+            }
+        } else if constexpr ( tmp_adiabatic_reservoir ) {
+            const Type::complex in_rv = adiabatic_reservoir( i, args, args.dev_ptrs.pump_plus, in_psi_norm );
+            wf_plus += args.p.one_over_h_bar_s * args.p.g_r * in_rv * in_wf_mi;
+            wf_plus += Type::real( 0.5 ) * args.p.R * in_rv * in_wf;
         }
 
         if constexpr ( tmp_use_potential ) {
@@ -129,10 +193,17 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar( int i, Type::uint32 cur
         Type::complex hamilton_regular_plus = args.p.m2_over_dx2_p_dy2 * in_wf_plus + horizontal_plus + vertical_plus;
         Type::complex hamilton_regular_minus = args.p.m2_over_dx2_p_dy2 * in_wf_minus + horizontal_minus + vertical_minus;
 
-        const Type::complex in_rv_plus = io.in_rv_plus[i];
-        const Type::complex in_rv_minus = io.in_rv_minus[i];
         const Type::real in_psi_plus_norm = CUDA::abs2( in_wf_plus );
         const Type::real in_psi_minus_norm = CUDA::abs2( in_wf_minus );
+        Type::complex in_rv_plus = 0.0;
+        Type::complex in_rv_minus = 0.0;
+        if constexpr ( tmp_adiabatic_reservoir ) {
+            in_rv_plus = adiabatic_reservoir( i, args, args.dev_ptrs.pump_plus, in_psi_plus_norm );
+            in_rv_minus = adiabatic_reservoir( i, args, args.dev_ptrs.pump_minus, in_psi_minus_norm );
+        } else if constexpr ( tmp_use_reservoir ) {
+            in_rv_plus = io.in_rv_plus[i];
+            in_rv_minus = io.in_rv_minus[i];
+        }
 
         // MARK: Wavefunction Plus
         // -i/hbar * H
@@ -173,19 +244,21 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar( int i, Type::uint32 cur
         io.out_wf_plus[i] = result;
 
         // MARK: Reservoir Plus
-        result = -( args.p.gamma_r + args.p.R * in_psi_plus_norm ) * in_rv_plus;
+        if constexpr ( tmp_use_reservoir and tmp_evolve_reservoir ) {
+            result = -( args.p.gamma_r + args.p.R * in_psi_plus_norm ) * in_rv_plus;
 
-        for ( int k = 0; k < args.pump_pointers.n; k++ ) {
-            const auto gauss = args.pump_pointers.amp[k];
-            PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
-            result += args.dev_ptrs.pump_plus[i + offset] * gauss; // TODO: remove this complex multiplication!
-        }
+            for ( int k = 0; k < args.pump_pointers.n; k++ ) {
+                const auto gauss = args.pump_pointers.amp[k];
+                PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
+                result += args.dev_ptrs.pump_plus[i + offset] * gauss; // TODO: remove this complex multiplication!
+            }
 
-        // MARK: Stochastic-2
-        if ( args.p.stochastic_amplitude > 0.0 )
-            result += args.p.R * in_rv_plus / args.p.dV;
+            // MARK: Stochastic-2
+            if ( args.p.stochastic_amplitude > 0.0 )
+                result += args.p.R * in_rv_plus / args.p.dV;
 
-        io.out_rv_plus[i] = result;
+            io.out_rv_plus[i] = result;
+        }
 
         // MARK: Wavefunction Minus
         result = args.p.one_over_h_bar_s * args.p.m_eff_scaled * hamilton_regular_minus;
@@ -219,19 +292,21 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar( int i, Type::uint32 cur
         io.out_wf_minus[i] = result;
 
         // MARK: Reservoir Minus
-        result = -( args.p.gamma_r + args.p.R * in_psi_minus_norm ) * in_rv_minus;
+        if constexpr ( tmp_use_reservoir and tmp_evolve_reservoir ) {
+            result = -( args.p.gamma_r + args.p.R * in_psi_minus_norm ) * in_rv_minus;
 
-        for ( int k = 0; k < args.pump_pointers.n; k++ ) {
-            const auto gauss = args.pump_pointers.amp[k];
-            PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
-            result += args.dev_ptrs.pump_minus[i + offset] * gauss; // TODO: remove this complex multiplication!
-        }
+            for ( int k = 0; k < args.pump_pointers.n; k++ ) {
+                const auto gauss = args.pump_pointers.amp[k];
+                PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
+                result += args.dev_ptrs.pump_minus[i + offset] * gauss; // TODO: remove this complex multiplication!
+            }
 
-        // MARK: Stochastic-2
-        if ( args.p.stochastic_amplitude > 0.0 )
-            result += args.p.R * in_rv_minus / args.p.dV;
+            // MARK: Stochastic-2
+            if ( args.p.stochastic_amplitude > 0.0 )
+                result += args.p.R * in_rv_minus / args.p.dV;
 
-        io.out_rv_minus[i] = result;
+            io.out_rv_minus[i] = result;
+        }
     }
 }
 
@@ -261,6 +336,81 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_linear_fourier( int i, S
     }
 }
 
+/**
+ * Multiplies the transformed wavefunction by -k^2 / N2 in place, such that its inverse transform
+ * is the spectral Laplacian. Uses the same k-vector as gp_scalar_linear_fourier.
+ */
+PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_spectral_laplacian( int i, Solver::KernelArguments args, Type::complex* wavefunction ) {
+    GET_THREAD_INDEX( i, args.p.N2 );
+
+    Type::real row = Type::real( Type::uint32( i / args.p.N_c ) );
+    Type::real col = Type::real( Type::uint32( i % args.p.N_c ) );
+
+    const Type::real k_x = 2.0 * 3.1415926535 * Type::real( col <= args.p.N_c / 2 ? col : -Type::real( args.p.N_c ) + col ) / args.p.L_x;
+    const Type::real k_y = 2.0 * 3.1415926535 * Type::real( row <= args.p.N_r / 2 ? row : -Type::real( args.p.N_r ) + row ) / args.p.L_y;
+    wavefunction[i] *= -( k_x * k_x + k_y * k_y ) / Type::real( args.p.N2 );
+}
+
+/**
+ * Evaluates the k-space propagator exp(-i E_k dt) / N2 of the linear step once, such that
+ * the SSFM linear step reduces to a single complex multiplication per cell. If mask is not
+ * a nullptr, the FFT mask (or its square root for half steps) is folded into the propagator,
+ * such that the wavefunction is filtered once per full step.
+ * In TE/TM mode, the TE-TM splitting couples the components via delta_LT (d_x +- i d_y)^2, which
+ * is -delta_LT (k_x +- i k_y)^2 in k-space. Per k, the linear Hamiltonian is then the 2x2 matrix
+ * [[E, b], [b*, E]] with b = -delta_LT/hbar (k_x + i k_y)^2, and its exponential is evaluated exactly:
+ * exp(-i E dt) * ( cos(|b| dt) - i sin(|b| dt)/|b| [[0, b], [b*, 0]] ). The diagonal is written to
+ * propagator[i], the plus <- minus element to propagator[i+N2] and the minus <- plus element to propagator[i+2*N2].
+ */
+template <bool tmp_use_tetm>
+PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_linear_fourier_propagator( int i, Solver::KernelArguments args, Type::real dt, Type::real* mask, bool sqrt_mask, Type::complex* propagator ) {
+    GET_THREAD_INDEX( i, args.p.N2 );
+
+    Type::real row = Type::real( Type::uint32( i / args.p.N_c ) );
+    Type::real col = Type::real( Type::uint32( i % args.p.N_c ) );
+
+    const Type::real k_x = 2.0 * 3.1415926535 * Type::real( col <= args.p.N_c / 2 ? col : -Type::real( args.p.N_c ) + col ) / args.p.L_x;
+    const Type::real k_y = 2.0 * 3.1415926535 * Type::real( row <= args.p.N_r / 2 ? row : -Type::real( args.p.N_r ) + row ) / args.p.L_y;
+    Type::real linear = args.p.h_bar_s / 2.0 / args.p.m_eff * ( k_x * k_x + k_y * k_y );
+
+    Type::complex result = CUDA::exp( args.p.minus_i * linear * dt ) / Type::real( args.p.N2 );
+    if ( mask != nullptr )
+        result *= sqrt_mask ? CUDA::sqrt( mask[i] ) : mask[i];
+    if constexpr ( not tmp_use_tetm ) {
+        propagator[i] = result;
+    } else {
+        // b = -delta_LT/hbar * (k_x + i k_y)^2
+        const Type::complex b = -args.p.one_over_h_bar_s * args.p.delta_LT * Type::complex( k_x * k_x - k_y * k_y, Type::real( 2.0 ) * k_x * k_y );
+        const Type::real b_abs = CUDA::sqrt( CUDA::abs2( b ) );
+        // exp(-i |b| dt) = cos(|b| dt) - i sin(|b| dt)
+        const Type::complex rotation = CUDA::exp( args.p.minus_i * b_abs * dt );
+        // sin(|b| dt)/|b| approaches dt for |b| -> 0
+        const Type::real sinc = b_abs > Type::real( 0.0 ) ? -CUDA::imag( rotation ) / b_abs : dt;
+        propagator[i] = result * CUDA::real( rotation );
+        propagator[i + args.p.N2] = result * args.p.minus_i * sinc * b;
+        propagator[i + 2 * args.p.N2] = result * args.p.minus_i * sinc * CUDA::conjugate( b );
+    }
+}
+
+/**
+ * Linear SSFM step using a cached propagator from gp_scalar_linear_fourier_propagator.
+ * In TE/TM mode, the 2x2 propagator mixes the plus and minus components.
+ */
+template <bool tmp_use_tetm>
+PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_linear_fourier_cached( int i, Solver::KernelArguments args, Solver::InputOutput io, Type::complex* propagator ) {
+    GET_THREAD_INDEX( i, args.p.N2 );
+
+    const Type::complex u = propagator[i];
+    if constexpr ( not tmp_use_tetm ) {
+        io.out_wf_plus[i] = io.in_wf_plus[i] * u;
+    } else {
+        const Type::complex in_wf_plus = io.in_wf_plus[i];
+        const Type::complex in_wf_minus = io.in_wf_minus[i];
+        io.out_wf_plus[i] = in_wf_plus * u + in_wf_minus * propagator[i + args.p.N2];
+        io.out_wf_minus[i] = in_wf_minus * u + in_wf_plus * propagator[i + 2 * args.p.N2];
+    }
+}
+
 template <bool tmp_use_tetm>
 PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_nonlinear( int i, Solver::KernelArguments args, Solver::InputOutput io ) {
     GET_THREAD_INDEX( i, args.p.N2 );
@@ -322,8 +472,8 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_nonlinear( int i, Solver
         result += args.p.g_r * in_rv_plus;
         result += args.p.i * args.p.h_bar_s * Type::real( 0.5 ) * args.p.R * in_rv_plus;
 
+        // The TE-TM splitting delta_LT is part of the linear k-space propagator
         Type::complex cross = args.p.g_pm * in_psi_minus_norm;
-        //cross += args.p.delta_LT * hamilton_cross_plus;
 
         // MARK: Stochastic
         if ( args.p.stochastic_amplitude > 0.0 ) {
@@ -358,7 +508,6 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_nonlinear( int i, Solver
         result += args.p.i * args.p.h_bar_s * Type::real( 0.5 ) * args.p.R * in_rv_minus;
 
         cross = args.p.g_pm * in_psi_plus_norm;
-        //cross += args.p.delta_LT * hamilton_cross_minus;
 
         // MARK: Stochastic
         if ( args.p.stochastic_amplitude > 0.0 ) {
@@ -382,6 +531,71 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_nonlinear( int i, Solver
     }
 }
 
+/**
+ * Right hand side of the GP equation without the linear kinetic (and TE-TM splitting) part, which
+ * the integrating factor RK4 propagates exactly in k-space. Evaluated on the full grid like the SSFM
+ * kernels. The noise is added as a constant forcing dW/dt, such that it enters once per step.
+ */
+template <bool tmp_use_tetm, bool tmp_use_reservoir>
+PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_nonlinear_rhs( int i, Solver::KernelArguments args, Solver::InputOutput io ) {
+    GET_THREAD_INDEX( i, args.p.N2 );
+
+    const Type::uint32 components = tmp_use_tetm ? 2 : 1;
+    for ( Type::uint32 c = 0; c < components; c++ ) {
+        const Type::complex in_wf = c == 0 ? io.in_wf_plus[i] : io.in_wf_minus[i];
+        const Type::complex in_wf_mi = CUDA::mi_conjugate( in_wf );
+        const Type::real in_psi_norm = CUDA::abs2( in_wf );
+        const Type::real* potential = c == 0 ? args.dev_ptrs.potential_plus : args.dev_ptrs.potential_minus;
+        const Type::complex* pulse = c == 0 ? args.dev_ptrs.pulse_plus : args.dev_ptrs.pulse_minus;
+
+        // MARK: Wavefunction
+        Type::complex energy = args.p.g_c * in_psi_norm;
+        if constexpr ( tmp_use_tetm ) {
+            energy += args.p.g_pm * CUDA::abs2( c == 0 ? io.in_wf_minus[i] : io.in_wf_plus[i] );
+        }
+        for ( int k = 0; k < args.potential_pointers.n; k++ ) {
+            PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
+            energy += potential[i + offset] * args.potential_pointers.amp[k];
+        }
+        Type::complex result = args.p.one_over_h_bar_s * energy * in_wf_mi;
+        result -= Type::real( 0.5 ) * args.p.gamma_c * in_wf;
+
+        for ( int k = 0; k < args.pulse_pointers.n; k++ ) {
+            PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
+            result += args.p.one_over_h_bar_s * pulse[i + offset] * args.pulse_pointers.amp[k];
+        }
+
+        Type::complex in_rv = 0.0;
+        if constexpr ( tmp_use_reservoir ) {
+            in_rv = c == 0 ? io.in_rv_plus[i] : io.in_rv_minus[i];
+            result += args.p.one_over_h_bar_s * args.p.g_r * in_rv * in_wf_mi;
+            result += Type::real( 0.5 ) * args.p.R * in_rv * in_wf;
+        }
+
+        // MARK: Stochastic
+        if ( args.p.stochastic_amplitude > 0.0 ) {
+            const Type::complex dw = args.dev_ptrs.random_number[i] * CUDA::sqrt( ( args.p.R * in_rv + args.p.gamma_c ) / ( Type::real( 4.0 ) * args.p.dV ) );
+            result -= args.p.one_over_h_bar_s * args.p.g_c * in_wf_mi / args.p.dV;
+            result += dw / args.time[1];
+        }
+
+        ( c == 0 ? io.out_wf_plus : io.out_wf_minus )[i] = result;
+
+        // MARK: Reservoir
+        if constexpr ( tmp_use_reservoir ) {
+            const Type::real* pump = c == 0 ? args.dev_ptrs.pump_plus : args.dev_ptrs.pump_minus;
+            result = -( args.p.gamma_r + args.p.R * in_psi_norm ) * in_rv;
+            for ( int k = 0; k < args.pump_pointers.n; k++ ) {
+                PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
+                result += pump[i + offset] * args.pump_pointers.amp[k];
+            }
+            if ( args.p.stochastic_amplitude > 0.0 )
+                result += args.p.R * in_rv / args.p.dV;
+            ( c == 0 ? io.out_rv_plus : io.out_rv_minus )[i] = result;
+        }
+    }
+}
+
 // This kernel is somewhat special, because the reservoir input holds the old reservoir (before the fullstep)
 // and the output reservoir hols the new reservoir. We need to use the old reservoir for calculations and then
 // write the new reservoir to the output.
@@ -412,7 +626,7 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_independent( int i, Solv
         for ( int k = 0; k < args.pulse_pointers.n; k++ ) {
             PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
             const Type::complex pulse = args.dev_ptrs.pulse_plus[i + offset];
-            result += args.p.minus_i_over_h_bar_s * args.time[1] * pulse * args.pulse_pointers.amp[k]; //CUDA::gaussian_complex_oscillator(t, args.pulse_pointers.t0[k], args.pulse_pointers.sigma[k], args.pulse_pointers.freq[k]);
+            result += args.p.one_over_h_bar_s * args.time[1] * pulse * args.pulse_pointers.amp[k]; //CUDA::gaussian_complex_oscillator(t, args.pulse_pointers.t0[k], args.pulse_pointers.sigma[k], args.pulse_pointers.freq[k]);
         }
         if ( args.p.stochastic_amplitude > 0.0 ) {
             const Type::complex in_rv = io.in_rv_plus[i];
@@ -420,6 +634,8 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_independent( int i, Solv
             result += dw;
         }
         io.out_wf_plus[i] = io.in_wf_plus[i] + result;
+        // Swap the reservoirs
+        io.out_rv_plus[i] = io.in_rv_plus[i];
 
         // MARK: Minus
         result = 0.0;
@@ -428,7 +644,7 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_independent( int i, Solv
         for ( int k = 0; k < args.pulse_pointers.n; k++ ) {
             PHOENIX::Type::uint32 offset = args.p.subgrid_N2_with_halo * k;
             const Type::complex pulse = args.dev_ptrs.pulse_minus[i + offset];
-            result += args.p.minus_i_over_h_bar_s * args.time[1] * pulse * args.pulse_pointers.amp[k]; //CUDA::gaussian_complex_oscillator(t, args.pulse_pointers.t0[k], args.pulse_pointers.sigma[k], args.pulse_pointers.freq[k]);
+            result += args.p.one_over_h_bar_s * args.time[1] * pulse * args.pulse_pointers.amp[k]; //CUDA::gaussian_complex_oscillator(t, args.pulse_pointers.t0[k], args.pulse_pointers.sigma[k], args.pulse_pointers.freq[k]);
         }
         if ( args.p.stochastic_amplitude > 0.0 ) {
             const Type::complex in_rv = io.in_rv_minus[i];
@@ -436,6 +652,52 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_scalar_independent( int i, Solv
             result += dw;
         }
         io.out_wf_minus[i] = io.in_wf_minus[i] + result;
+        io.out_rv_minus[i] = io.in_rv_minus[i];
+    }
+}
+
+/**
+ * Reservoir subcycling (--reservoirSubcycle n). The reservoir equation
+ * dn/dt = -a n + P with a = gamma_r + R |Psi|^2
+ * is integrated with the trapezoidal rule over a cycle of n wavefunction steps, while the wavefunction
+ * couples to the reservoir predicted for the middle of the cycle. The cycle start stores n_0 and the
+ * explicit part -a_0 n_0 + P_0 in the first two k_reservoir slots, which are otherwise unused.
+ * Both kernels are pointwise and evaluated on the subgrid without halo.
+ */
+// Starts a cycle of length cycle_time. The reservoir is replaced by its prediction for the middle of the cycle.
+template <bool tmp_use_tetm>
+PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_reservoir_cycle_begin( int i, Type::uint32 current_halo, Solver::KernelArguments args, Type::real cycle_time ) {
+    GENERATE_SUBGRID_INDEX( i, current_halo );
+
+    const Type::uint32 components = tmp_use_tetm ? 2 : 1;
+    for ( Type::uint32 c = 0; c < components; c++ ) {
+        Type::complex* reservoir = c == 0 ? args.dev_ptrs.reservoir_plus : args.dev_ptrs.reservoir_minus;
+        Type::complex* k_reservoir = c == 0 ? args.dev_ptrs.k_reservoir_plus : args.dev_ptrs.k_reservoir_minus;
+        const Type::real rate = reservoir_loss_rate( args, CUDA::abs2( ( c == 0 ? args.dev_ptrs.wavefunction_plus : args.dev_ptrs.wavefunction_minus )[i] ) );
+        const Type::complex pump = reservoir_pump( i, args, c == 0 ? args.dev_ptrs.pump_plus : args.dev_ptrs.pump_minus );
+        const Type::complex in_rv = reservoir[i];
+        const Type::complex explicit_part = pump - rate * in_rv;
+        k_reservoir[i] = in_rv;
+        k_reservoir[i + args.p.subgrid_N2_with_halo] = explicit_part;
+        // Trapezoidal half cycle with the wavefunction and pump of the cycle start
+        const Type::real quarter_cycle = Type::real( 0.25 ) * cycle_time;
+        reservoir[i] = ( in_rv + quarter_cycle * ( explicit_part + pump ) ) / ( Type::real( 1.0 ) + quarter_cycle * rate );
+    }
+}
+
+// Completes the current cycle after elapsed_time. The trapezoidal rule is implicit in n, which is solved for exactly.
+template <bool tmp_use_tetm>
+PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void gp_reservoir_cycle_complete( int i, Type::uint32 current_halo, Solver::KernelArguments args, Type::real elapsed_time ) {
+    GENERATE_SUBGRID_INDEX( i, current_halo );
+
+    const Type::uint32 components = tmp_use_tetm ? 2 : 1;
+    for ( Type::uint32 c = 0; c < components; c++ ) {
+        Type::complex* reservoir = c == 0 ? args.dev_ptrs.reservoir_plus : args.dev_ptrs.reservoir_minus;
+        Type::complex* k_reservoir = c == 0 ? args.dev_ptrs.k_reservoir_plus : args.dev_ptrs.k_reservoir_minus;
+        const Type::real rate = reservoir_loss_rate( args, CUDA::abs2( ( c == 0 ? args.dev_ptrs.wavefunction_plus : args.dev_ptrs.wavefunction_minus )[i] ) );
+        const Type::complex pump = reservoir_pump( i, args, c == 0 ? args.dev_ptrs.pump_plus : args.dev_ptrs.pump_minus );
+        const Type::real half_cycle = Type::real( 0.5 ) * elapsed_time;
+        reservoir[i] = ( k_reservoir[i] + half_cycle * ( k_reservoir[i + args.p.subgrid_N2_with_halo] + pump ) ) / ( Type::real( 1.0 ) + half_cycle * rate );
     }
 }
 
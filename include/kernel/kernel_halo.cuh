@@ -1,6 +1,9 @@
 #pragma once
 #include "cuda/typedef.cuh"
 #include "cuda/cuda_macro.cuh"
+#ifdef USE_CPU
+    #include <cstring>
+#endif
 
 namespace PHOENIX::Kernel::Halo {
 
@@ -42,36 +45,104 @@ PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void halo_grid_to_full_grid( int i, Typ
     fullgrid[i] = subgrids[subgrid][r_subgrid * subgrid_with_halo + c_subgrid];
 }
 
-template <typename T>
-PHOENIX_DEVICE PHOENIX_INLINE void __synchronize_halo( Type::uint32 subgrid_to, Type::uint32 index_to, Type::uint32 subgrid_from, Type::uint32 index_from, T** current_subgridded_matrix ) {
-    current_subgridded_matrix[subgrid_to][index_to] = current_subgridded_matrix[subgrid_from][index_from];
+/**
+ * The halo of a subgrid consists of eight rectangles, one per neighbour (dr, dc). Each is a copy of a rectangle of the
+ * neighbour, or zero if the neighbour lies outside of a non-periodic boundary. from and to are the indices of the upper
+ * left cells of the rectangles within the subgrids. The rows of a rectangle are contiguous, so the halos are
+ * synchronized row by row. first_row is the number of rows of the previous rectangles, such that the rows of all
+ * rectangles can be enumerated. The rectangles are the same for every subgrid, see Solver::initializeHaloMap.
+ */
+struct HaloRectangle {
+    int dr, dc;
+    Type::uint32 from, to;
+    Type::uint32 rows, cols;
+    Type::uint32 first_row;
+};
+
+// Returns the rectangle that contains the halo row and makes row relative to it.
+PHOENIX_DEVICE PHOENIX_INLINE const HaloRectangle& __halo_rectangle( const HaloRectangle* rectangles, Type::uint32& row ) {
+    Type::uint32 r = 0;
+    while ( row >= rectangles[r].first_row + rectangles[r].rows ) r++;
+    row -= rectangles[r].first_row;
+    return rectangles[r];
+}
+
+// Returns the neighbour of the subgrid the rectangle is copied from, or -1 outside of a non-periodic boundary.
+template <bool periodic_x, bool periodic_y>
+PHOENIX_DEVICE PHOENIX_INLINE int __halo_neighbour( const Type::uint32 subgrid, const HaloRectangle& rectangle, const Type::uint32 subgrids_columns, const Type::uint32 subgrids_rows ) {
+    const int R = int( subgrid / subgrids_columns ) + rectangle.dr;
+    const int C = int( subgrid % subgrids_columns ) + rectangle.dc;
+    if constexpr ( not periodic_y ) {
+        if ( R < 0 or R >= int( subgrids_rows ) )
+            return -1;
+    }
+    if constexpr ( not periodic_x ) {
+        if ( C < 0 or C >= int( subgrids_columns ) )
+            return -1;
+    }
+    return ( ( R + subgrids_rows ) % subgrids_rows ) * subgrids_columns + ( C + subgrids_columns ) % subgrids_columns;
 }
 
 template <typename T>
-PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void synchronize_halos( int i, Type::uint32 subgrids_columns, Type::uint32 subgrids_rows, Type::uint32 subgrid_N_c, Type::uint32 subgrid_N_r, Type::uint32 halo_size, Type::uint32 halo_num, bool periodic_boundary_x, bool periodic_boundary_y, int* subgrid_map, T** current_subgridded_matrix ) {
-    GET_THREAD_INDEX( i, halo_num * subgrids_columns * subgrids_rows );
+PHOENIX_DEVICE PHOENIX_INLINE void __copy_halo_row( T* to, const T* from, const Type::uint32 cols ) {
+#ifdef USE_CPU
+    std::memcpy( to, from, cols * sizeof( T ) );
+#else
+    for ( Type::uint32 c = 0; c < cols; c++ ) to[c] = from[c];
+#endif
+}
 
-    const Type::uint32 sg = i / halo_num;        // subgrid index from 0 to subgrids_columns*subgrids_rows.
-    const Type::uint32 s = ( i % halo_num ) * 6; // subgrid_map index from 0 to 6*len(subgrid_map)
+template <typename T>
+PHOENIX_DEVICE PHOENIX_INLINE void __zero_halo_row( T* to, const Type::uint32 cols ) {
+    for ( Type::uint32 c = 0; c < cols; c++ ) to[c] = 0;
+}
 
-    const int R = sg / subgrids_columns;
-    const int C = sg % subgrids_columns;
-    const Type::uint32 subgrid = R * subgrids_columns + C;
+// Synchronizes row i % halo_rows of the halo of subgrid i / halo_rows. The boundary conditions are compile time
+// parameters, so the periodic case does not branch.
+template <bool periodic_x, bool periodic_y, typename T>
+PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void synchronize_halos( int i, Type::uint32 subgrids_columns, Type::uint32 subgrids_rows, Type::uint32 row_offset, Type::uint32 halo_rows, HaloRectangle* rectangles, T** current_subgridded_matrix ) {
+    GET_THREAD_INDEX( i, halo_rows * subgrids_columns * subgrids_rows );
+
+    const Type::uint32 subgrid = i / halo_rows;
+    Type::uint32 row = i % halo_rows;
+    const HaloRectangle& rectangle = __halo_rectangle( rectangles, row );
+    T* to = current_subgridded_matrix[subgrid] + rectangle.to + row * row_offset;
+
+    const int neighbour = __halo_neighbour<periodic_x, periodic_y>( subgrid, rectangle, subgrids_columns, subgrids_rows );
+    if ( neighbour < 0 ) {
+        __zero_halo_row( to, rectangle.cols );
+        return;
+    }
+    __copy_halo_row( to, current_subgridded_matrix[neighbour] + rectangle.from + row * row_offset, rectangle.cols );
+}
 
-    const auto dr = subgrid_map[s];
-    const auto dc = subgrid_map[s + 1];
-    const auto fr = subgrid_map[s + 2];
-    const auto fc = subgrid_map[s + 3];
-    const auto tr = subgrid_map[s + 4];
-    const auto tc = subgrid_map[s + 5];
-
-    // Subgrid remains zero if the boundary condition is not periodic
-    if ( ( !periodic_boundary_x && ( C + dc < 0 || C + dc >= subgrids_columns ) ) or ( !periodic_boundary_y && ( R + dr < 0 || R + dr >= subgrids_rows ) ) ) {
-        current_subgridded_matrix[subgrid][tr * ( subgrid_N_c + 2 * halo_size ) + tc] = 0;
-    } else {
-        const Type::uint32 r_new = ( R + dr ) % subgrids_rows;
-        const Type::uint32 c_new = ( C + dc ) % subgrids_columns;
-        __synchronize_halo( subgrid, tr * ( subgrid_N_c + 2 * halo_size ) + tc, r_new * subgrids_columns + c_new, fr * ( subgrid_N_c + 2 * halo_size ) + fc, current_subgridded_matrix );
+// Halo synchronization for local time stepping. Only the halos of the active subgrids, which start a step, are
+// synchronized. A neighbour that is within a longer step of its own holds its state at the end of that step and
+// the state at its beginning in previous_subgridded_matrix. Its halo value is then interpolated linearly in time,
+// with the fraction of its step that has passed given by weight. A weight of one copies the current state.
+template <bool periodic_x, bool periodic_y, typename T>
+PHOENIX_GLOBAL PHOENIX_COMPILER_SPECIFIC void synchronize_halos_interpolated( int i, Type::uint32 subgrids_columns, Type::uint32 subgrids_rows, Type::uint32 row_offset, Type::uint32 halo_rows, HaloRectangle* rectangles, T** current_subgridded_matrix, T** previous_subgridded_matrix, Type::real* weight, Type::uint32* active ) {
+    GET_THREAD_INDEX( i, halo_rows * subgrids_columns * subgrids_rows );
+
+    const Type::uint32 subgrid = i / halo_rows;
+    if ( not active[subgrid] )
+        return;
+    Type::uint32 row = i % halo_rows;
+    const HaloRectangle& rectangle = __halo_rectangle( rectangles, row );
+    T* to = current_subgridded_matrix[subgrid] + rectangle.to + row * row_offset;
+
+    const int neighbour = __halo_neighbour<periodic_x, periodic_y>( subgrid, rectangle, subgrids_columns, subgrids_rows );
+    if ( neighbour < 0 ) {
+        __zero_halo_row( to, rectangle.cols );
+        return;
+    }
+    const T* from = current_subgridded_matrix[neighbour] + rectangle.from + row * row_offset;
+    const Type::real w = weight[neighbour];
+    if ( w == Type::real( 1.0 ) ) {
+        __copy_halo_row( to, from, rectangle.cols );
+        return;
     }
+    const T* previous = previous_subgridded_matrix[neighbour] + rectangle.from + row * row_offset;
+    for ( Type::uint32 c = 0; c < rectangle.cols; c++ ) to[c] = previous[c] + w * ( from[c] - previous[c] );
 }
 } // namespace PHOENIX::Kernel::Halo
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <map>
 #include <functional>
+#include <vector>
+#include <memory>
+#include <string>
 #include "cuda/typedef.cuh"
 #include "cuda/cuda_matrix.cuh"
 #include "cuda/cuda_macro.cuh"
@@ -10,6 +13,7 @@
 #include "system/system_parameters.hpp"
 #include "system/filehandler.hpp"
 #include "solver/matrix_container.cuh"
+#include "solver/runge_kutta_tableau.hpp"
 #include "misc/escape_sequences.hpp"
 
 namespace PHOENIX {
@@ -58,6 +62,11 @@ class Solver {
     };
 
     Type::device_vector<Type::real> time; // [0] is t, [1] is dt
+    Type::device_vector<Type::real> substep_time; // [2k] is t, [2k+1] is dt of substep k of the higher order splitting
+
+    // Cells of a subgrid the CPU subgrid kernel calls iterate. The interior of a call excludes the cells that depend on
+    // the halo, i.e. the cells within halo_size of the boundary of the region the call is made for. The border is the rest.
+    enum class SubgridRegion { Full, Interior, Border };
 
     struct KernelArguments {
         TemporalEvelope::Pointers pulse_pointers;     // The pointers to the envelopes. These are obtained by calling the .pointers() method on the envelopes.
@@ -66,6 +75,13 @@ class Solver {
         Type::real* time;                             // Pointer to Device Memory of the time array. [0] is t, [1] is dt
         MatrixContainer::Pointers dev_ptrs;           // All the pointers to the matrices. These are obtained by calling the .pointers() method on the matrices.
         SystemParameters::KernelParameters p;         // The kernel parameters. These are obtained by copying the kernel_parameters object of the system.
+        SubgridRegion region = SubgridRegion::Full;   // Only read by the CPU subgrid kernel calls, see OVERLAPPED_SOLVER_SEQUENCE.
+    };
+
+    // Weights of the k's for the dense output, see beginDenseOutput. The Butcher tableau schemes have up to four stages.
+    struct DenseOutputWeights {
+        Type::real w[4];
+        Type::uint32 stages;
     };
 
     // Fixed Kernel Arguments. Every Compute Kernel will take one of these.
@@ -79,14 +95,20 @@ class Solver {
         kernel_arguments.time = GET_RAW_PTR( time );
         return kernel_arguments;
     }
+    // Kernel arguments of every subgrid, generated by the CPU SOLVER_SEQUENCE on first use
+    std::vector<KernelArguments> solver_sequence_arguments;
 
     // Cache Maps
     std::map<std::string, std::vector<Type::real>> cache_map_scalar;
 
-    Solver( PHOENIX::SystemParameters& system ) : system( system ), filehandler( system.filehandler ) {
+    // A propagator only owns the matrices and is advanced by propagate, see iterateParareal. It does not report or output anything.
+    Solver( PHOENIX::SystemParameters& system, const bool propagator = false ) : system( system ), filehandler( system.filehandler ) {
         std::cout << PHOENIX::CLIO::prettyPrint( "Creating Solver...", PHOENIX::CLIO::Control::Info ) << std::endl;
         // Initialize all matrices
         initializeMatricesFromSystem();
+        if ( propagator )
+            return;
+        reportStableTimestep();
         // Then output all matrices to file. If --output was not passed in argv, this method outputs everything.
 #ifndef BENCH
         outputInitialMatrices();
@@ -95,6 +117,7 @@ class Solver {
 
     void initializeMatricesFromSystem(); // Evaluates the envelopes and initializes the matrices
     void initializeHaloMap();            // Initializes the halo map
+    void reportStableTimestep();         // Prints the estimated stability limit for the initial state
 
     // Output (Final) Host Matrices to files
     void outputMatrices( const Type::uint32 start_x, const Type::uint32 end_x, const Type::uint32 start_y, const Type::uint32 end_y, const Type::uint32 increment, const std::string& suffix = "", const std::string& prefix = "" );
@@ -109,26 +132,148 @@ class Solver {
     void iterateNewton();
     void iterateFixedTimestepRungeKutta3();
     void iterateFixedTimestepRungeKutta4();
+    // Fixed timestep explicit RK iterator for any Butcher tableau from runge_kutta_tableau.hpp
+    template <typename Tableau>
+    void iterateFixedTimestepRungeKutta();
+    // With evolve_reservoir = false, the reservoir is held fixed and only the wavefunction is advanced.
+    // The sequence starts at first_stage, if the previous stages have been evaluated separately.
+    template <typename Tableau, bool evolve_reservoir = true, Type::uint32 first_stage = 1>
+    void rungeKuttaSequence( const Type::uint32 subgrid, KernelArguments& kernel_arguments, Type::stream_t& stream );
+    template <typename Tableau, Type::uint32 Stage, bool evolve_reservoir = true>
+    void rungeKuttaStage( const Type::uint32 subgrid, KernelArguments& kernel_arguments, Type::stream_t& stream );
+    // A stage consists of summing its input and evaluating its k. The spectral Laplacian is evaluated in between.
+    template <typename Tableau, Type::uint32 Stage, bool evolve_reservoir = true>
+    void rungeKuttaStageInput( const Type::uint32 subgrid, KernelArguments& kernel_arguments, Type::stream_t& stream );
+    template <typename Tableau, Type::uint32 Stage, bool evolve_reservoir = true>
+    void rungeKuttaStageDerivative( const Type::uint32 subgrid, KernelArguments& kernel_arguments, Type::stream_t& stream );
+    // Fixed timestep RK with the pseudo-spectral Laplacian, see --stencil spectral.
+    template <typename Tableau, bool evolve_reservoir = true>
+    void spectralRungeKuttaSequence();
+    template <typename Tableau, Type::uint32 Stage, bool evolve_reservoir = true>
+    void spectralRungeKuttaStage();
+    // Writes the spectral Laplacian of the input wavefunction to the k matrix slot.
+    void spectralLaplacian( CUDAMatrix<Type::complex>& input, const Type::uint32 slot );
+    // Fixed timestep RK with the halos exchanged before every stage, see --haloDepth 1.
+    template <typename Tableau>
+    void stagewiseRungeKuttaSequence();
+    template <typename Tableau, Type::uint32 Stage>
+    void stagewiseRungeKuttaStage();
+    // Halo in which the k of stage index is valid. The stages of a step start from the part of the halo that the previous
+    // steps since the last exchange have not consumed, see --haloDepth. The final sum of a step is evaluated in stageHalo( 0 ).
+    Type::uint32 stageHalo( const Type::uint32 index ) const {
+        if ( system.halo_depth == 1 )
+            return 0;
+        return system.p.halo_size - halo_consumed - index * system.p.stencil_radius;
+    }
+    // Halo consumed by the steps since the last halo exchange. Reset to 0 to force an exchange before the next step.
+    Type::uint32 halo_consumed = 0;
+    // Multi-rate stepping of the reservoir, see --reservoirSubcycle and gp_reservoir_cycle_begin.
+    void beginReservoirCycle();
+    // Advances the reservoir to the current time. Call before the physical reservoir is needed.
+    void completeReservoirCycle();
+    Type::uint32 reservoir_cycle_steps = 0;
+    Type::real reservoir_cycle_time = 0.0;
+    // Local time stepping, see --localTimestep. Every subgrid subcycles the step with dt / 2^level.
+    template <typename Tableau>
+    void iterateLocalTimestepRungeKutta();
+    // Assigns the levels from the estimated stability limits of the subgrids.
+    void updateLocalTimestepLevels();
+    std::vector<Type::uint32> local_timestep_level;
+    Type::real local_timestep_update_t = 0.0;
+    Type::device_vector<Type::real> local_timestep_time;        // [2l] is t, [2l+1] is dt of level l
+    Type::device_vector<Type::real> local_timestep_halo_weight; // Fraction of its current local step every subgrid has passed
+    Type::device_vector<Type::uint32> local_timestep_active;    // Whether a subgrid starts a local step
+    // Fixed timestep low storage (2N) RK iterator. Needs a single k matrix regardless of the number of stages.
+    template <typename Tableau>
+    void iterateFixedTimestepLowStorageRungeKutta();
+    template <typename Tableau, Type::uint32 Stage>
+    void lowStorageRungeKuttaStage( const Type::uint32 subgrid, KernelArguments& kernel_arguments, Type::stream_t& stream );
+    template <float A, float B, bool include_dw, bool include_reservoir>
+    void lowStorageUpdate( KernelArguments& kernel_arguments, Type::stream_t& stream, const Type::uint32 current_halo, Type::complex* state, Type::complex* k, Type::complex* increment );
     void iterateVariableTimestepRungeKutta();
     void iterateSplitStepFourier();
+    void iterateSplitStepFourier4();
+    void iterateIntegratingFactorRungeKutta();
+    // Building blocks of the split step iterators
+    void splitStepLinear( KernelArguments& kernel_arguments, Type::complex* in, Type::complex* propagator );
+    Type::complex* splitStepGather( KernelArguments& kernel_arguments );
+    // Rebuilds the cached SSFM k-space propagators for the given fractions of dt if dt or the fractions changed.
+    void updateFourierPropagator( const std::vector<Type::real>& fractions, const bool fold_mask = true );
+    Type::complex* getFourierPropagator( const Type::uint32 index ) {
+        return GET_RAW_PTR( matrix.fft_propagator ) + index * getFourierPropagatorSize();
+    }
+    Type::uint32 getFourierPropagatorSize() {
+        return system.use_twin_mode ? 3 * system.p.N2 : system.p.N2;
+    }
+    // Applies the trailing linear half step the fused SSFM keeps pending. Call before the physical wavefunction is needed.
+    void completeSplitStep();
+    std::vector<Type::real> fourier_propagator_fractions;
+    Type::real fourier_propagator_dt = 0.0;
+    bool fft_mask_in_propagator = false;
+    bool split_step_pending = false;
+    // Constant coefficients of the ADI tridiagonal systems along one direction, see kernel_adi.cuh.
+    struct ADICoefficients {
+        Type::complex* c_prime;             // Thomas algorithm c'_j
+        Type::complex* inverse_denominator; // 1 / (b_j - a c'_(j-1))
+        Type::complex* z;                   // Sherman-Morrison correction vector for periodic lines
+        Type::complex off_diagonal;
+        Type::complex corner_ratio;
+        Type::complex correction_factor;
+    } adi_x, adi_y;
+    Type::real adi_dt = 0.0;
+    void iterateAlternatingDirectionImplicit();
+    // Rebuilds the ADI coefficients for the half steps of the current dt if dt changed.
+    void updateADICoefficients();
+    // Crank-Nicolson step of the kinetic term over dt/2, as a row and a column sweep. The buffer holds the intermediate result.
+    void alternatingDirectionHalfStep( Type::complex* in, Type::complex* buffer, Type::complex* out );
+    // dt proposed by an adaptive iterator for the next step. Zero for fixed timestep iterators.
+    Type::real adaptive_dt = 0.0;
+    // Dense output: the state at a time within the last step is interpolated from its k's, such that the output
+    // does not have to shrink dt. beginDenseOutput replaces the state by the interpolation and sets t accordingly,
+    // endDenseOutput restores the state at the end of the step.
+    bool supportsDenseOutput();
+    void beginDenseOutput( const Type::real t );
+    void endDenseOutput();
+    bool dense_output_active = false;
+    Type::real dense_output_t = 0.0;
+    // Largest stable dt of the iterator for the current state, see --autoTimestep. Infinity if dt is not limited.
+    Type::real estimateStableTimestep();
+    // The same for every subgrid, see --localTimestep
+    std::vector<Type::real> estimateStableTimestepPerSubgrid();
+    Type::real stableTimestep( const Type::real psi_max, const Type::real reservoir_max, const Type::real potential_max );
     void normalizeImaginaryTimePropagation();
+    // Parareal time parallel integration, see --parareal. The coarse propagator runs serially on this solver, while the
+    // fine propagators advance the time slices concurrently on their own solvers. These share the system, but own their matrices.
+    // Integrates one window of slices and calls output at the end of every slice.
+    void iterateParareal( const std::function<void()>& output );
+    // Advances the state from t to t_end with the given iterator in equal steps of at most dt and returns the number of steps.
+    // The system time is left untouched, such that the propagators of the parareal mode can run concurrently.
+    Type::uint32 propagate( const std::string& name, const Type::real t, const Type::real t_end, const Type::real dt );
+    // Copies the wavefunction and the reservoir to and from a full grid state, stacked as [Psi+ | n+ | Psi- | n-]
+    void getState( Type::device_vector<Type::complex>& state );
+    void setState( Type::device_vector<Type::complex>& state );
+    std::vector<std::unique_ptr<Solver>> parareal_propagators;
+    Type::uint32 parareal_iterations = 0;
 
     struct iteratorFunction {
         int k_max;
         std::function<void()> iterate;
     };
-    std::map<std::string, iteratorFunction> iterator = { { "newton", { 1, std::bind( &Solver::iterateNewton, this ) } }, { "rk4", { 4, std::bind( &Solver::iterateFixedTimestepRungeKutta4, this ) } }, { "ssfm", { 0, std::bind( &Solver::iterateSplitStepFourier, this ) } } };
+    std::map<std::string, iteratorFunction> iterator = { { "newton", { 1, std::bind( &Solver::iterateNewton, this ) } }, { "ralston", { RungeKutta::Ralston::stages, std::bind( &Solver::iterateFixedTimestepRungeKutta<RungeKutta::Ralston>, this ) } }, { "rk3", { RungeKutta::RK3::stages, std::bind( &Solver::iterateFixedTimestepRungeKutta3, this ) } }, { "ssprk3", { RungeKutta::SSPRK3::stages, std::bind( &Solver::iterateFixedTimestepRungeKutta<RungeKutta::SSPRK3>, this ) } }, { "rk4", { RungeKutta::RK4::stages, std::bind( &Solver::iterateFixedTimestepRungeKutta4, this ) } }, { "lsrk4", { 1, std::bind( &Solver::iterateFixedTimestepLowStorageRungeKutta<RungeKutta::LowStorageRK4>, this ) } }, { "rk45", { 7, std::bind( &Solver::iterateVariableTimestepRungeKutta, this ) } }, { "ssfm", { 0, std::bind( &Solver::iterateSplitStepFourier, this ) } }, { "ssfm4", { 0, std::bind( &Solver::iterateSplitStepFourier4, this ) } }, { "ifrk4", { 4, std::bind( &Solver::iterateIntegratingFactorRungeKutta, this ) } }, { "adi", { 0, std::bind( &Solver::iterateAlternatingDirectionImplicit, this ) } } };
 
     // Main System function. Either gp_scalar or gp_tetm.
     // Both functions have signature void(int i, Type::uint32 current_halo, Solver::VKernelArguments time, Solver::KernelArguments args, Solver::InputOutput io)
     std::function<void( int, Type::uint32, KernelArguments, InputOutput )> runge_function;
 
     bool iterate();
+    // Evaluates the temporal envelopes at t and updates the time array of the kernels
+    void updateKernelArguments( const Type::real t, const Type::real dt );
 
     void applyFFTFilter( bool apply_mask = true );
 
     enum class FFT { inverse, forward };
-    void calculateFFT( Type::complex* device_ptr_in, Type::complex* device_ptr_out, FFT dir );
+    // Transforms 'batch' stacked matrices of size N_c*N_r, e.g. the [plus | minus] components of matrix.fft, in a single call.
+    void calculateFFT( Type::complex* device_ptr_in, Type::complex* device_ptr_out, FFT dir, Type::uint32 batch = 1 );
 
     void cacheValues();
     void cacheMatrices();
@@ -1,6 +1,7 @@
 #pragma once
 #include "cuda/typedef.cuh"
 #include "cuda/cuda_matrix.cuh"
+#include "kernel/kernel_halo.cuh"
 
 namespace PHOENIX {
 
@@ -27,6 +28,9 @@ struct MatrixContainer {
 #ifdef BENCH
     PHOENIX::CUDAMatrix<Type::complex> buffer_wavefunction_iplus, buffer_wavefunction_iminus;
 #endif
+    // States at the beginning of the current local time step of every subgrid, see --localTimestep.
+    // Constructed by the local time stepping on first use.
+    PHOENIX::CUDAMatrix<Type::complex> previous_wavefunction_plus, previous_wavefunction_minus, previous_reservoir_plus, previous_reservoir_minus;
     // Corresponding initial States. These are simple host vectors, not CUDAMatrices.
     PHOENIX::Type::host_vector<Type::complex> initial_state_plus, initial_state_minus, initial_reservoir_plus, initial_reservoir_minus;
 
@@ -34,8 +38,14 @@ struct MatrixContainer {
     PHOENIX::CUDAMatrix<Type::complex> pulse_plus, pulse_minus;
     PHOENIX::CUDAMatrix<Type::real> pump_plus, pump_minus, potential_plus, potential_minus;
 
-    // FFT Matrices. These are simple device vectors, not CUDAMatrices.
-    PHOENIX::Type::device_vector<Type::complex> fft_plus, fft_minus;
+    // FFT Matrices. These are simple device vectors, not CUDAMatrices. The plus and minus components are
+    // stacked as [plus | minus] into a single vector, such that both can be transformed by one batched FFT.
+    PHOENIX::Type::device_vector<Type::complex> fft, buffer_fft;
+    // Cached k-space propagators of the SSFM linear steps, stacked for every fraction of dt. Constructed by the SSFM on first use.
+    // In TE/TM mode, every fraction holds the 2x2 propagator as [diagonal | plus from minus | minus from plus].
+    PHOENIX::Type::device_vector<Type::complex> fft_propagator;
+    // Tridiagonal coefficients of the ADI iterator, [c' | 1/den | z] for the rows, then for the columns. Constructed by the ADI iterator on first use.
+    PHOENIX::Type::device_vector<Type::complex> adi_coefficients;
     PHOENIX::Type::device_vector<Type::real> fft_mask_plus, fft_mask_minus;
 
     // Random Number generator and buffer. We only need a single random number matrix of size subgrid_x*subgrid_y
@@ -49,8 +59,9 @@ struct MatrixContainer {
     // K Matrices. These are vectors of CUDAMatrices.
     PHOENIX::CUDAMatrix<Type::complex> k_wavefunction_plus, k_wavefunction_minus, k_reservoir_plus, k_reservoir_minus;
 
-    // Halo Map
-    PHOENIX::Type::device_vector<int> halo_map;
+    // Halo rectangles and their total number of rows, see Kernel::Halo::HaloRectangle
+    PHOENIX::Type::device_vector<Kernel::Halo::HaloRectangle> halo_rectangles;
+    Type::uint32 halo_rows = 0;
 
 // User Defined Matrices
 #ifdef MATRIX_LIST
@@ -103,7 +114,8 @@ struct MatrixContainer {
 
         // FFT Matrices
         if ( use_fft ) {
-            fft_plus = PHOENIX::Type::device_vector<Type::complex>( N_c * N_r );
+            fft = PHOENIX::Type::device_vector<Type::complex>( ( use_twin_mode ? 2 : 1 ) * N_c * N_r );
+            buffer_fft = PHOENIX::Type::device_vector<Type::complex>( ( use_twin_mode ? 2 : 1 ) * N_c * N_r );
             fft_mask_plus = PHOENIX::Type::device_vector<Type::real>( N_c * N_r );
         }
 
@@ -120,14 +132,9 @@ struct MatrixContainer {
         }
 
         // RK Error Matrix. For now, use k_max > 4 as a construction condition.
-        // TODO: we removed RK45, so we dont need this any more.
         if ( k_max > 4 )
             rk_error.construct( N_r, N_c, subgrids_columns, subgrids_rows, halo_size, "rk_error" );
 
-        // Construct the halo map. 6*total halo points because we have 6 coordinates for each point
-        const Type::uint32 total_halo_points = ( N_c + 2 * halo_size ) * ( N_r + 2 * halo_size ) - N_c * N_r;
-        halo_map = PHOENIX::Type::device_vector<int>( total_halo_points * 6 );
-
         // User defined matrices
 #ifdef MATRIX_LIST
     #define DEFINE_MATRIX( type, name ) name.construct( N_r, N_c, subgrids_columns, subgrids_rows, halo_size, #name );
@@ -168,7 +175,6 @@ struct MatrixContainer {
 
         // FFT Matrices
         if ( use_fft ) {
-            fft_minus = PHOENIX::Type::device_vector<Type::complex>( N_c * N_r );
             fft_mask_minus = PHOENIX::Type::device_vector<Type::real>( N_c * N_r );
         }
     }
@@ -210,6 +216,8 @@ struct MatrixContainer {
         // FFT Matrices
         Type::complex* fft_plus = nullptr;
         Type::complex* fft_minus = nullptr;
+        Type::complex* buffer_fft_plus = nullptr;
+        Type::complex* buffer_fft_minus = nullptr;
         Type::real* fft_mask_plus = nullptr;
         Type::real* fft_mask_minus = nullptr;
 
@@ -220,8 +228,8 @@ struct MatrixContainer {
         // RK Error
         Type::complex* rk_error = nullptr;
 
-        // Halo Map
-        int* halo_map = nullptr;
+        // Halo Rectangles
+        Kernel::Halo::HaloRectangle* halo_rectangles = nullptr;
 
         // Custom Components
 #ifdef MATRIX_LIST
@@ -262,8 +270,9 @@ struct MatrixContainer {
         ptrs.k_reservoir_plus = k_reservoir_plus.getDevicePtr( subgrid );
 
         // FFT Matrices
-        ptrs.fft_plus = GET_RAW_PTR( fft_plus );
         if ( use_fft ) {
+            ptrs.fft_plus = GET_RAW_PTR( fft );
+            ptrs.buffer_fft_plus = GET_RAW_PTR( buffer_fft );
             ptrs.fft_mask_plus = GET_RAW_PTR( fft_mask_plus );
         }
 
@@ -276,7 +285,7 @@ struct MatrixContainer {
         ptrs.rk_error = rk_error.getDevicePtr( subgrid );
 
         // Halo Map
-        ptrs.halo_map = GET_RAW_PTR( halo_map );
+        ptrs.halo_rectangles = GET_RAW_PTR( halo_rectangles );
 
         // User Defined Matrices
 #ifdef MATRIX_LIST
@@ -308,8 +317,9 @@ struct MatrixContainer {
         ptrs.k_reservoir_minus = k_reservoir_minus.getDevicePtr( subgrid );
 
         // FFT Matrices
-        ptrs.fft_minus = GET_RAW_PTR( fft_minus );
         if ( use_fft ) {
+            ptrs.fft_minus = ptrs.fft_plus + fft.size() / 2;
+            ptrs.buffer_fft_minus = ptrs.buffer_fft_plus + buffer_fft.size() / 2;
             ptrs.fft_mask_minus = GET_RAW_PTR( fft_mask_minus );
         }
 
@@ -0,0 +1,107 @@
+#pragma once
+#include <array>
+#include "cuda/typedef.cuh"
+
+namespace PHOENIX::RungeKutta {
+
+/**
+ * Explicit Runge-Kutta schemes as compile time Butcher tableaus.
+ * a[s] holds the weights of k_1 ... k_s for the input of stage s+1 (a[0] is unused),
+ * b holds the weights of the final sum. The nodes c are not needed, because the
+ * envelopes are evaluated once at the beginning of the step.
+ * Solver::iterateFixedTimestepRungeKutta<Tableau> generates the stage sums from these tables.
+ * To add a scheme, add a tableau here and register it in Solver::iterator and in the halo
+ * map of SystemParameters::init using haloSize.
+ */
+
+// Ralston's second order method. Minimal error bound of all two stage methods.
+struct Ralston {
+    static constexpr Type::uint32 stages = 2;
+    static constexpr float a[stages][stages] = { { 0.0f, 0.0f }, { 2.0f / 3.0f, 0.0f } };
+    static constexpr float b[stages] = { 1.0f / 4.0f, 3.0f / 4.0f };
+};
+
+// Kutta's third order method
+struct RK3 {
+    static constexpr Type::uint32 stages = 3;
+    static constexpr float a[stages][stages] = { { 0.0f, 0.0f, 0.0f }, { 1.0f / 2.0f, 0.0f, 0.0f }, { -1.0f, 2.0f, 0.0f } };
+    static constexpr float b[stages] = { 1.0f / 6.0f, 2.0f / 3.0f, 1.0f / 6.0f };
+};
+
+// Strong stability preserving third order method (Shu-Osher)
+struct SSPRK3 {
+    static constexpr Type::uint32 stages = 3;
+    static constexpr float a[stages][stages] = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 1.0f / 4.0f, 1.0f / 4.0f, 0.0f } };
+    static constexpr float b[stages] = { 1.0f / 6.0f, 1.0f / 6.0f, 2.0f / 3.0f };
+};
+
+// Classical fourth order method
+struct RK4 {
+    static constexpr Type::uint32 stages = 4;
+    static constexpr float a[stages][stages] = { { 0.0f, 0.0f, 0.0f, 0.0f }, { 1.0f / 2.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f / 2.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 0.0f } };
+    static constexpr float b[stages] = { 1.0f / 6.0f, 1.0f / 3.0f, 1.0f / 3.0f, 1.0f / 6.0f };
+    // Third order continuous extension, see denseWeights
+    static constexpr float dense[stages][3] = { { 1.0f, -3.0f / 2.0f, 2.0f / 3.0f }, { 0.0f, 1.0f, -2.0f / 3.0f }, { 0.0f, 1.0f, -2.0f / 3.0f }, { 0.0f, -1.0f / 2.0f, 2.0f / 3.0f } };
+};
+
+// Carpenter-Kennedy five stage fourth order low storage (2N) method. Instead of a Butcher tableau,
+// the scheme is given in Williamson form: every stage computes k_s = f(y), then the increment
+// dy = A_s * dy + dt * k_s and updates y += B_s * dy in place. Only one k matrix is required.
+struct LowStorageRK4 {
+    static constexpr Type::uint32 stages = 5;
+    static constexpr float A[stages] = { 0.0f, -567301805773.0f / 1357537059087.0f, -2404267990393.0f / 2016746695238.0f, -3550918686646.0f / 2091501179385.0f, -1275806237668.0f / 842570457699.0f };
+    static constexpr float B[stages] = { 1432997174477.0f / 9575080441755.0f, 5161836677717.0f / 13612068292357.0f, 1720146321549.0f / 2090206949498.0f, 3134564353537.0f / 4481467310338.0f, 2277821191437.0f / 14882151754819.0f };
+};
+
+// Every stage evaluates the stencil once, shrinking the valid region by one cell. A scheme with
+// s stages thus needs a halo of s cells to advance a subgrid without intermediate synchronization.
+// Higher order stencils shrink it by their radius, which SystemParameters::init scales the halo with.
+template <typename Tableau>
+constexpr Type::uint32 haloSize() {
+    return Tableau::stages;
+}
+
+// Stability function R(z) of the scheme, i.e. the amplification y_(n+1) = R(z) y_n of the test equation
+// y' = lambda y with z = lambda dt. Evaluated by applying the stages of the tableau to the test equation.
+template <typename Tableau>
+Type::complex stabilityFunction( const Type::complex z ) {
+    if constexpr ( requires { Tableau::A; } ) {
+        // Williamson form of the low storage schemes
+        Type::complex y = 1.0;
+        Type::complex dy = 0.0;
+        for ( Type::uint32 s = 0; s < Tableau::stages; s++ ) {
+            dy = Type::real( Tableau::A[s] ) * dy + z * y;
+            y += Type::real( Tableau::B[s] ) * dy;
+        }
+        return y;
+    } else {
+        Type::complex stage[Tableau::stages];
+        Type::complex sum = 0.0;
+        for ( Type::uint32 s = 0; s < Tableau::stages; s++ ) {
+            Type::complex input = 0.0;
+            for ( Type::uint32 j = 0; j < s; j++ ) input += Type::real( Tableau::a[s][j] ) * stage[j];
+            stage[s] = Type::real( 1.0 ) + z * input;
+            sum += Type::real( Tableau::b[s] ) * stage[s];
+        }
+        return Type::real( 1.0 ) + z * sum;
+    }
+}
+
+// Weights b_i(theta) of the continuous extension y(t + theta dt) = y(t) + dt * sum_i b_i(theta) k_i, which interpolates
+// a step from its k's at no additional cost, see Solver::beginDenseOutput. A scheme may define dense[i], the coefficients
+// of theta, theta^2 and theta^3 in b_i(theta). Otherwise, the quadratic Hermite interpolant of y(t), k_1 and y(t + dt)
+// is used, which is second order for every scheme of order two or higher.
+template <typename Tableau>
+std::array<Type::real, Tableau::stages> denseWeights( const Type::real theta ) {
+    std::array<Type::real, Tableau::stages> weights;
+    for ( Type::uint32 s = 0; s < Tableau::stages; s++ ) {
+        if constexpr ( requires { Tableau::dense; } ) {
+            weights[s] = theta * ( Tableau::dense[s][0] + theta * ( Tableau::dense[s][1] + theta * Tableau::dense[s][2] ) );
+        } else {
+            weights[s] = theta * theta * Tableau::b[s] + ( s == 0 ? theta * ( Type::real( 1.0 ) - theta ) : Type::real( 0.0 ) );
+        }
+    }
+    return weights;
+}
+
+} // namespace PHOENIX::RungeKutta
@@ -27,6 +27,8 @@ class SystemParameters {
         Type::uint32 N_c, N_r, N2;
         // Subgrid and Halo
         Type::uint32 halo_size;
+        // Radius of the finite difference Laplacian. The halo is scaled by this radius. 0 for the spectral Laplacian.
+        Type::uint32 stencil_radius;
         Type::uint32 subgrid_N_c, subgrid_N_r, subgrid_N2, subgrid_N2_with_halo, subgrid_row_offset;
         Type::uint32 subgrids_columns, subgrids_rows; // For now, subgrids_columns = subgrids_rows at all times, even if N_c != N_r
         // Time variables
@@ -73,12 +75,35 @@ class SystemParameters {
     Type::real t_max, dt_max, dt_min, tolerance, fft_every, random_system_amplitude, magic_timestep;
 
     // Kernel Block Size
-    Type::uint32 block_size, omp_max_threads;
+    Type::uint32 block_size, omp_max_threads, fft_threads;
 
     // Initialize the system randomly
     bool randomly_initialize_system;
 
     std::string iterator;
+    // Merge the trailing and leading linear half steps of consecutive SSFM steps
+    bool ssfm_fused;
+    // Advance the reservoir only every reservoir_subcycle wavefunction steps. 1 evolves it in every stage.
+    Type::uint32 reservoir_subcycle;
+    // Order of the finite difference Laplacian. 2 is the 5-point stencil, 4 and 6 use 9 and 13 points.
+    Type::uint32 stencil_order;
+    // Evaluate the Laplacian of every RK stage by FFT instead, see --stencil spectral. Periodic boundaries only.
+    bool use_spectral_laplacian;
+    // Adapt dt between outputs to this fraction of the estimated stability limit. 0 keeps dt fixed.
+    Type::real auto_timestep;
+    // Stage evaluations between two halo exchanges of the fixed timestep RK iterators. 1 exchanges before every stage, a
+    // multiple of the stages every halo_depth / stages steps. 0 uses the number of stages, i.e. one exchange per step.
+    Type::uint32 halo_depth;
+    // Local time stepping. Every subgrid subcycles dt with dt / 2^l, where l is at most local_timestep_levels. 0 disables it.
+    Type::uint32 local_timestep_levels;
+    // Parareal time parallel integration over windows of parareal_slices output intervals. 0 disables it.
+    Type::uint32 parareal_slices;
+    // Iterator and dt of the coarse propagator. The iteration stops once the relative change of the slices is below the tolerance.
+    std::string parareal_coarse_iterator;
+    Type::real parareal_coarse_dt, parareal_tolerance;
+
+    // FFTW planner effort (estimate, measure, patient, exhaustive) and optional wisdom file. CPU only.
+    std::string fft_planner, fft_wisdom;
 
     // Seed for random number generator
     Type::uint32 random_seed;
@@ -97,6 +122,8 @@ class SystemParameters {
 
     // Flags for the different system branches. These will be set after the input is read.
     bool use_reservoir, use_pulses, use_pumps, use_potentials, use_stochastic, use_twin_mode, use_fft_mask;
+    // The reservoir is eliminated adiabatically. use_reservoir is false in this case.
+    bool use_adiabatic_reservoir;
 
     // Output of Variables
     std::vector<std::string> output_keys;
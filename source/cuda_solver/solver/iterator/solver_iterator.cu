@@ -16,6 +16,25 @@
 PHOENIX::Type::real fft_cached_t = 0.0;
 bool first_time = true;
 
+/**
+ * The envelopes of the system are evaluated in place, so this is a critical section for
+ * the propagators of the parareal mode, which share the system.
+ */
+void PHOENIX::Solver::updateKernelArguments( const Type::real t, const Type::real dt ) {
+#pragma omp critical( temporal_envelope )
+    {
+        system.pulse.updateTemporal( t );
+        system.potential.updateTemporal( t );
+        system.pump.updateTemporal( t );
+        dev_pulse_oscillation.amp = system.pulse.temporal_envelope;
+        dev_potential_oscillation.amp = system.potential.temporal_envelope;
+        dev_pump_oscillation.amp = system.pump.temporal_envelope;
+    }
+    // Update the time struct. This is required for variable time steps, and when the kernels need t or dt.
+    Type::host_vector<Type::real> new_time = { t, dt };
+    time = new_time;
+}
+
 /**
  * Iterates the Runge-Kutta-Method on the GPU
  * Note, that all device arrays and variables have to be initialized at this point
@@ -43,17 +62,7 @@ bool PHOENIX::Solver::iterate() {
         }
         CALL_FULL_KERNEL( PHOENIX::Kernel::generate_random_numbers, "random_number_gen", grid_size, block_size, 0, args.dev_ptrs.random_state, args.dev_ptrs.random_number, system.p.subgrid_N2_with_halo, system.p.stochastic_amplitude * std::sqrt( system.p.dt ), system.p.stochastic_amplitude * std::sqrt( system.p.dt ) );
     }
-    // TODO: Hide this in a solver.updateKernelArgs function
-    system.pulse.updateTemporal( system.p.t );
-    system.potential.updateTemporal( system.p.t );
-    system.pump.updateTemporal( system.p.t );
-    // Update the time struct. This is required for variable time steps, and when the kernels need t or dt.
-    Type::host_vector<Type::real> new_time = { system.p.t, system.p.dt };
-    // And update the solver struct accordingly
-    dev_pulse_oscillation.amp = system.pulse.temporal_envelope;
-    dev_potential_oscillation.amp = system.potential.temporal_envelope;
-    dev_pump_oscillation.amp = system.pump.temporal_envelope;
-    time = new_time;
+    updateKernelArguments( system.p.t, system.p.dt );
 
     // Iterate RK4(45)/ssfm/itp
     iterator[system.iterator].iterate();
@@ -74,7 +83,11 @@ bool PHOENIX::Solver::iterate() {
 
     // Calculate the FFT
     fft_cached_t = system.p.t;
-    applyFFTFilter( system.fft_mask.size() > 0 );
+    // The filter needs the physical wavefunction. If the mask is part of the SSFM propagator, only the
+    // visualized FFT is calculated, the magnitude of which is not affected by a pending linear half step.
+    if ( not fft_mask_in_propagator )
+        completeSplitStep();
+    applyFFTFilter( system.fft_mask.size() > 0 and not fft_mask_in_propagator );
 
     return true;
 }
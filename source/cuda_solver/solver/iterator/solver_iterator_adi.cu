@@ -0,0 +1,165 @@
+#include <omp.h>
+
+// Include Cuda Kernel headers
+#include "cuda/typedef.cuh"
+#include "kernel/kernel_compute.cuh"
+#include "kernel/kernel_adi.cuh"
+#include "system/system_parameters.hpp"
+#include "cuda/cuda_matrix.cuh"
+#include "solver/gpu_solver.hpp"
+#include "misc/commandline_io.hpp"
+
+/**
+ * Precomputes the Thomas algorithm coefficients of (1 - a D) for a line of n points, where D is the
+ * second difference and a = tau/2 alpha / h^2. The matrix has b = 1 + 2a on the diagonal and -a on the
+ * off diagonals. For periodic lines, the corner elements are split off as u v^T with u = (gamma, 0, ..., 0, -a)
+ * and v = (1, 0, ..., 0, -a/gamma), and the solution is corrected using z = A'^-1 u (Sherman-Morrison).
+ */
+static void computeADILine( PHOENIX::Type::host_vector<PHOENIX::Type::complex>& host, const PHOENIX::Type::uint32 offset, const PHOENIX::Type::uint32 n, const PHOENIX::Type::complex a, const bool periodic, PHOENIX::Solver::ADICoefficients& coefficients ) {
+    using namespace PHOENIX;
+    const Type::complex b = Type::real( 1.0 ) + Type::real( 2.0 ) * a;
+    const Type::complex e = -a;
+    const Type::complex gamma = -b;
+    Type::complex* c_prime = host.data() + offset;
+    Type::complex* inverse_denominator = c_prime + n;
+    Type::complex* z = inverse_denominator + n;
+
+    for ( Type::uint32 j = 0; j < n; j++ ) {
+        Type::complex diagonal = b;
+        if ( periodic and j == 0 )
+            diagonal = b - gamma;
+        if ( periodic and j == n - 1 )
+            diagonal = b - e * e / gamma;
+        const Type::complex denominator = j == 0 ? diagonal : diagonal - e * c_prime[j - 1];
+        inverse_denominator[j] = Type::real( 1.0 ) / denominator;
+        c_prime[j] = e * inverse_denominator[j];
+    }
+
+    coefficients.off_diagonal = e;
+    coefficients.corner_ratio = e / gamma;
+    coefficients.correction_factor = 0.0;
+    if ( not periodic )
+        return;
+    // z = A'^-1 u
+    for ( Type::uint32 j = 0; j < n; j++ ) {
+        const Type::complex u = j == 0 ? gamma : ( j == n - 1 ? e : Type::complex( 0.0 ) );
+        z[j] = ( u - ( j == 0 ? Type::complex( 0.0 ) : e * z[j - 1] ) ) * inverse_denominator[j];
+    }
+    for ( int j = int( n ) - 2; j >= 0; j-- )
+        z[j] -= c_prime[j] * z[j + 1];
+    coefficients.correction_factor = Type::real( 1.0 ) / ( Type::real( 1.0 ) + z[0] + coefficients.corner_ratio * z[n - 1] );
+}
+
+void PHOENIX::Solver::updateADICoefficients() {
+    if ( system.p.dt == adi_dt )
+        return;
+    adi_dt = system.p.dt;
+
+    // The kinetic term is alpha * Laplace(Psi) with alpha = -i/hbar * m_eff_scaled. Every half step covers dt/2,
+    // the implicit part of each of its two sweeps dt/4.
+    const Type::complex alpha = Type::complex( 0.0, -system.p.m_eff_scaled * system.p.one_over_h_bar_s );
+    const Type::complex a_x = Type::real( 0.25 ) * system.p.dt * alpha * system.p.one_over_dx2;
+    const Type::complex a_y = Type::real( 0.25 ) * system.p.dt * alpha * system.p.one_over_dy2;
+
+    Type::host_vector<Type::complex> host( 3 * ( system.p.N_c + system.p.N_r ) );
+    computeADILine( host, 0, system.p.N_c, a_x, system.p.periodic_boundary_x, adi_x );
+    computeADILine( host, 3 * system.p.N_c, system.p.N_r, a_y, system.p.periodic_boundary_y, adi_y );
+    matrix.adi_coefficients = host;
+
+    Type::complex* device = GET_RAW_PTR( matrix.adi_coefficients );
+    adi_x.c_prime = device;
+    adi_x.inverse_denominator = device + system.p.N_c;
+    adi_x.z = device + 2 * system.p.N_c;
+    device += 3 * system.p.N_c;
+    adi_y.c_prime = device;
+    adi_y.inverse_denominator = device + system.p.N_r;
+    adi_y.z = device + 2 * system.p.N_r;
+}
+
+void PHOENIX::Solver::alternatingDirectionHalfStep( Type::complex* in, Type::complex* buffer, Type::complex* out ) {
+    const Type::uint32 N_c = system.p.N_c;
+    const Type::uint32 N_r = system.p.N_r;
+    const bool periodic_x = system.p.periodic_boundary_x;
+    const bool periodic_y = system.p.periodic_boundary_y;
+    const Type::complex alpha = Type::complex( 0.0, -system.p.m_eff_scaled * system.p.one_over_h_bar_s );
+    // Explicit weights, (dt/4) alpha / h^2 of the direction perpendicular to the sweep
+    const Type::complex weight_y = Type::real( 0.25 ) * system.p.dt * alpha * system.p.one_over_dy2;
+    const Type::complex weight_x = Type::real( 0.25 ) * system.p.dt * alpha * system.p.one_over_dx2;
+
+    // Row sweep: implicit in x, explicit in y. One line per row.
+    {
+        auto [block_size, grid_size] = getLaunchParameters( N_r );
+        if ( periodic_x ) {
+            if ( periodic_y ) {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::adi_sweep<GCC_EXPAND_VA_ARGS( true, true )>, "adi_rows", grid_size, block_size, 0, in, buffer, adi_x, weight_y, N_c, N_r, 1, N_c );
+            } else {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::adi_sweep<GCC_EXPAND_VA_ARGS( true, false )>, "adi_rows", grid_size, block_size, 0, in, buffer, adi_x, weight_y, N_c, N_r, 1, N_c );
+            }
+        } else {
+            if ( periodic_y ) {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::adi_sweep<GCC_EXPAND_VA_ARGS( false, true )>, "adi_rows", grid_size, block_size, 0, in, buffer, adi_x, weight_y, N_c, N_r, 1, N_c );
+            } else {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::adi_sweep<GCC_EXPAND_VA_ARGS( false, false )>, "adi_rows", grid_size, block_size, 0, in, buffer, adi_x, weight_y, N_c, N_r, 1, N_c );
+            }
+        }
+    }
+    // Column sweep: implicit in y, explicit in x. One line per column.
+    {
+        auto [block_size, grid_size] = getLaunchParameters( N_c );
+        if ( periodic_y ) {
+            if ( periodic_x ) {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::adi_sweep<GCC_EXPAND_VA_ARGS( true, true )>, "adi_columns", grid_size, block_size, 0, buffer, out, adi_y, weight_x, N_r, N_c, N_c, 1 );
+            } else {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::adi_sweep<GCC_EXPAND_VA_ARGS( true, false )>, "adi_columns", grid_size, block_size, 0, buffer, out, adi_y, weight_x, N_r, N_c, N_c, 1 );
+            }
+        } else {
+            if ( periodic_x ) {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::adi_sweep<GCC_EXPAND_VA_ARGS( false, true )>, "adi_columns", grid_size, block_size, 0, buffer, out, adi_y, weight_x, N_r, N_c, N_c, 1 );
+            } else {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::adi_sweep<GCC_EXPAND_VA_ARGS( false, false )>, "adi_columns", grid_size, block_size, 0, buffer, out, adi_y, weight_x, N_r, N_c, N_c, 1 );
+            }
+        }
+    }
+}
+
+/**
+ * Alternating Direction Implicit (Peaceman-Rachford) Crank-Nicolson iterator
+ * Strang splitting K(dt/2) N(dt) K(dt/2), where K is the kinetic term with the finite difference
+ * Laplacian, integrated by the unconditionally stable ADI scheme
+ * (1 - dt/4 alpha D_xx) Psi* = (1 + dt/4 alpha D_yy) Psi
+ * (1 - dt/4 alpha D_yy) Psi' = (1 + dt/4 alpha D_xx) Psi*
+ * per half step. The tridiagonal systems are solved in parallel along the rows and then the columns.
+ * N holds the nonlinear, potential, pump and reservoir terms and uses the same kernels as the SSFM,
+ * so unlike the SSFM, zero boundaries are supported. Works on the full grid and requires a single subgrid.
+ */
+void PHOENIX::Solver::iterateAlternatingDirectionImplicit() {
+    updateADICoefficients();
+
+    auto kernel_arguments = generateKernelArguments();
+    auto [block_size, grid_size] = getLaunchParameters( system.p.N_c, system.p.N_r );
+    auto& ptrs = kernel_arguments.dev_ptrs;
+
+    // Kinetic (Half) Step. Psi -> Psi
+    alternatingDirectionHalfStep( ptrs.wavefunction_plus, ptrs.buffer_wavefunction_plus, ptrs.wavefunction_plus );
+    if ( system.use_twin_mode )
+        alternatingDirectionHalfStep( ptrs.wavefunction_minus, ptrs.buffer_wavefunction_minus, ptrs.wavefunction_minus );
+
+    // Nonlinear Full Step. Psi -> Buffer
+    if ( system.use_twin_mode ) {
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear<true>, "nonlinear_full_step", grid_size, block_size, 0, kernel_arguments, { ptrs.wavefunction_plus, ptrs.wavefunction_minus, ptrs.reservoir_plus, ptrs.reservoir_minus, ptrs.buffer_wavefunction_plus, ptrs.buffer_wavefunction_minus, ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus } );
+    } else {
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear<false>, "nonlinear_full_step", grid_size, block_size, 0, kernel_arguments, { ptrs.wavefunction_plus, ptrs.wavefunction_minus, ptrs.reservoir_plus, ptrs.reservoir_minus, ptrs.buffer_wavefunction_plus, ptrs.buffer_wavefunction_minus, ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus } );
+    }
+
+    // Kinetic (Half) Step. Buffer -> Buffer
+    alternatingDirectionHalfStep( ptrs.buffer_wavefunction_plus, ptrs.wavefunction_plus, ptrs.buffer_wavefunction_plus );
+    if ( system.use_twin_mode )
+        alternatingDirectionHalfStep( ptrs.buffer_wavefunction_minus, ptrs.wavefunction_minus, ptrs.buffer_wavefunction_minus );
+
+    // Pulse, noise and reservoir swap. Buffer -> Psi
+    if ( system.use_twin_mode ) {
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_independent<true>, "independent", grid_size, block_size, 0, kernel_arguments, { ptrs.buffer_wavefunction_plus, ptrs.buffer_wavefunction_minus, ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus, ptrs.wavefunction_plus, ptrs.wavefunction_minus, ptrs.reservoir_plus, ptrs.reservoir_minus } );
+    } else {
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_independent<false>, "independent", grid_size, block_size, 0, kernel_arguments, { ptrs.buffer_wavefunction_plus, ptrs.buffer_wavefunction_minus, ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus, ptrs.wavefunction_plus, ptrs.wavefunction_minus, ptrs.reservoir_plus, ptrs.reservoir_minus } );
+    }
+}
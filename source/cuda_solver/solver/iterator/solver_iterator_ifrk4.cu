@@ -0,0 +1,133 @@
+#include <omp.h>
+#include <utility>
+
+// Include Cuda Kernel headers
+#include "cuda/typedef.cuh"
+#include "kernel/kernel_compute.cuh"
+#include "kernel/kernel_summation.cuh"
+#include "system/system_parameters.hpp"
+#include "cuda/cuda_matrix.cuh"
+#include "solver/gpu_solver.hpp"
+#include "solver/runge_kutta_tableau.hpp"
+#include "misc/commandline_io.hpp"
+
+/**
+ * Integrating factor RK4 (Lawson). The linear kinetic part L, including the TE-TM splitting, is
+ * propagated exactly in k-space using the cached SSFM propagator E = exp(L dt/2), while the classical
+ * RK4 is applied to the remaining terms N in the interaction picture:
+ * ------------------------------------------------------------------------------
+ * k1 = N(u)
+ * k2 = N(E (u + dt/2 k1))
+ * k3 = N(E u + dt/2 k2)
+ * k4 = N(E^2 u + dt E k3)
+ * next = E^2 u + dt/6 (E^2 k1 + 2 E (k2 + k3)) + dt/6 k4
+ * ------------------------------------------------------------------------------
+ * With A = E (u + dt/2 k1) and B = E u, E (u + dt/6 k1) = (A + 2B)/3, such that
+ * next = E ( (A + 2B)/3 + dt/3 (k2 + k3) ) + dt/6 k4 only needs four linear steps per step.
+ * The reservoir has no linear part and is integrated with the plain RK4. Because the stiff kinetic
+ * term no longer limits dt, the timestep can be much larger than the finite difference stability
+ * limit. Like the SSFM, this iterator works on the full grid and requires a single subgrid.
+ */
+void PHOENIX::Solver::iterateIntegratingFactorRungeKutta() {
+    // The FFT mask is applied by iterate() once per step, not by every linear step
+    updateFourierPropagator( { 0.5 }, false /*fold_mask*/ );
+
+    auto kernel_arguments = generateKernelArguments();
+    auto [block_size, grid_size] = getLaunchParameters( system.p.N_c, system.p.N_r );
+    auto& ptrs = kernel_arguments.dev_ptrs;
+    Type::complex* propagator = getFourierPropagator( 0 );
+    const Type::real dt = system.p.dt;
+    const Type::uint32 components = system.use_twin_mode ? 2 : 1;
+
+    // Linear steps read their input from buffer_fft and write to fft, both holding the stacked components.
+    Type::complex* wavefunction[2] = { ptrs.wavefunction_plus, ptrs.wavefunction_minus };
+    Type::complex* reservoir[2] = { ptrs.reservoir_plus, ptrs.reservoir_minus };
+    Type::complex* buffer_reservoir[2] = { ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus };
+    Type::complex* linear_in[2] = { ptrs.buffer_fft_plus, ptrs.buffer_fft_minus };
+    Type::complex* linear_out[2] = { ptrs.fft_plus, ptrs.fft_minus };
+    auto k_wavefunction = [&]( Type::uint32 c, Type::uint32 k ) { return c == 0 ? matrix.k_wavefunction_plus.getDevicePtr( 0, k ) : matrix.k_wavefunction_minus.getDevicePtr( 0, k ); };
+    auto k_reservoir = [&]( Type::uint32 c, Type::uint32 k ) { return c == 0 ? matrix.k_reservoir_plus.getDevicePtr( 0, k ) : matrix.k_reservoir_minus.getDevicePtr( 0, k ); };
+
+    // out = a * x + b * y
+    auto combine = [&]( Type::complex* out, Type::complex a, Type::complex* x, Type::complex b, Type::complex* y ) {
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Summation::full_linear_combination<Type::complex>, "if_combine", grid_size, block_size, 0, kernel_arguments, out, a, x, b, y );
+    };
+    // Reservoir input of the next stage, r + w * dt * k_r
+    auto reservoir_stage = [&]( Type::uint32 k, Type::real w ) {
+        if ( not system.use_reservoir )
+            return;
+        for ( Type::uint32 c = 0; c < components; c++ )
+            combine( buffer_reservoir[c], 1.0, reservoir[c], w * dt, k_reservoir( c, k ) );
+    };
+    // k = N(wf, rv)
+    auto rhs = [&]( Type::complex** wf, Type::complex** rv, Type::uint32 k ) {
+        Solver::InputOutput io{ wf[0], wf[1], rv[0], rv[1], k_wavefunction( 0, k ), system.use_twin_mode ? k_wavefunction( 1, k ) : nullptr, system.use_reservoir ? k_reservoir( 0, k ) : nullptr, system.use_reservoir and system.use_twin_mode ? k_reservoir( 1, k ) : nullptr };
+        if ( system.use_twin_mode ) {
+            if ( system.use_reservoir ) {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear_rhs<GCC_EXPAND_VA_ARGS( true, true )>, "if_rhs", grid_size, block_size, 0, kernel_arguments, io );
+            } else {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear_rhs<GCC_EXPAND_VA_ARGS( true, false )>, "if_rhs", grid_size, block_size, 0, kernel_arguments, io );
+            }
+        } else {
+            if ( system.use_reservoir ) {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear_rhs<GCC_EXPAND_VA_ARGS( false, true )>, "if_rhs", grid_size, block_size, 0, kernel_arguments, io );
+            } else {
+                CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear_rhs<GCC_EXPAND_VA_ARGS( false, false )>, "if_rhs", grid_size, block_size, 0, kernel_arguments, io );
+            }
+        }
+    };
+    // fft = E buffer_fft
+    auto linear = [&]() { splitStepLinear( kernel_arguments, linear_in[0], propagator ); };
+
+    // k1 = N(u)
+    rhs( wavefunction, reservoir, 0 );
+
+    // A = E (u + dt/2 k1), k2 = N(A)
+    for ( Type::uint32 c = 0; c < components; c++ )
+        combine( linear_in[c], 1.0, wavefunction[c], 0.5 * dt, k_wavefunction( c, 0 ) );
+    reservoir_stage( 0, 0.5 );
+    linear();
+    rhs( linear_out, buffer_reservoir, 1 );
+
+    // k1 of the wavefunction is no longer needed. Its slot accumulates S = (A + 2B)/3 + dt/3 (k2 + k3).
+    // B = E u
+    for ( Type::uint32 c = 0; c < components; c++ ) {
+        combine( k_wavefunction( c, 0 ), 1.0 / 3.0, linear_out[c], dt / 3.0, k_wavefunction( c, 1 ) );
+        combine( linear_in[c], 1.0, wavefunction[c], 0.0, wavefunction[c] );
+    }
+    linear();
+
+    // k3 = N(B + dt/2 k2)
+    for ( Type::uint32 c = 0; c < components; c++ ) {
+        combine( k_wavefunction( c, 0 ), 1.0, k_wavefunction( c, 0 ), 2.0 / 3.0, linear_out[c] );
+        combine( linear_in[c], 1.0, linear_out[c], 0.5 * dt, k_wavefunction( c, 1 ) );
+    }
+    reservoir_stage( 1, 0.5 );
+    rhs( linear_in, buffer_reservoir, 2 );
+
+    // C = E (B + dt k3), k4 = N(C)
+    for ( Type::uint32 c = 0; c < components; c++ ) {
+        combine( k_wavefunction( c, 0 ), 1.0, k_wavefunction( c, 0 ), dt / 3.0, k_wavefunction( c, 2 ) );
+        combine( linear_in[c], 1.0, linear_out[c], dt, k_wavefunction( c, 2 ) );
+    }
+    reservoir_stage( 2, 1.0 );
+    linear();
+    rhs( linear_out, buffer_reservoir, 3 );
+
+    // next = E S + dt/6 k4
+    for ( Type::uint32 c = 0; c < components; c++ )
+        combine( linear_in[c], 1.0, k_wavefunction( c, 0 ), 0.0, k_wavefunction( c, 0 ) );
+    linear();
+    for ( Type::uint32 c = 0; c < components; c++ )
+        combine( wavefunction[c], 1.0, linear_out[c], dt / 6.0, k_wavefunction( c, 3 ) );
+
+    // The reservoir uses the classical RK4 weights
+    if ( not system.use_reservoir )
+        return;
+    const Type::uint32 current_halo = 0;
+    for ( Type::uint32 c = 0; c < components; c++ ) {
+        [&]<Type::uint32... J>( std::integer_sequence<Type::uint32, J...> ) {
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::runge_add_to_input_k<GCC_EXPAND_VA_ARGS( Type::complex, false, false, false, RungeKutta::RK4::stages, RungeKutta::RK4::b[J]... )>, "if_reservoir", grid_size, block_size, 0, current_halo, kernel_arguments, reservoir[c], k_reservoir( c, 0 ) );
+        }( std::make_integer_sequence<Type::uint32, RungeKutta::RK4::stages>{} );
+    }
+}
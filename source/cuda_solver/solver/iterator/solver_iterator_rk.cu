@@ -0,0 +1,405 @@
+#include <omp.h>
+#include <utility>
+#include <algorithm>
+
+// Include Cuda Kernel headers
+#include "cuda/typedef.cuh"
+#include "kernel/kernel_compute.cuh"
+#include "kernel/kernel_summation.cuh"
+#include "kernel/kernel_halo.cuh"
+#include "system/system_parameters.hpp"
+#include "cuda/cuda_matrix.cuh"
+#include "solver/gpu_solver.hpp"
+#include "solver/runge_kutta_tableau.hpp"
+#include "misc/commandline_io.hpp"
+/*
+ * These functions iterate the Runge Kutta Kernel using a fixed time step.
+ * The scheme is given by a Butcher tableau from runge_kutta_tableau.hpp, from
+ * which the stage sums are generated at compile time. Calculation of the inputs
+ * for the next rungeFuncKernel call is done in a single fused summation kernel.
+ * The general implementation of an explicit RK method with s stages goes as follows:
+ * ------------------------------------------------------------------------------
+ * k1 = f(t, y) = rungeFuncKernel(current)
+ * input_for_k2 = current + dt * a21 * k1
+ * k2 = f(t + c2 * dt, input_for_k2) = rungeFuncKernel(input_for_k2)
+ * ...
+ * input_for_ks = current + dt * (as1 * k1 + ... + as(s-1) * k(s-1))
+ * ks = f(t + cs * dt, input_for_ks) = rungeFuncKernel(input_for_ks)
+ * next = current + dt * (b1 * k1 + ... + bs * ks)
+ * ------------------------------------------------------------------------------
+ * For RK4, a21 = a32 = 1/2, a43 = 1 and b = (1/6, 1/3, 1/3, 1/6).
+ * Every stage shrinks the region in which the k's are valid by one cell, which is why
+ * a scheme with s stages uses a halo of s cells (see RungeKutta::haloSize). With --stencil 4 or 6,
+ * this is scaled by the stencil radius.
+ * With --reservoirSubcycle n, the stages only advance the wavefunction, while the reservoir
+ * is held fixed and advanced once every n steps by beginReservoirCycle and completeReservoirCycle.
+ * With --stencil spectral, the Laplacian of every stage input is evaluated by FFT on the full grid,
+ * see spectralRungeKuttaSequence. The halo is then zero.
+ * With --localTimestep, every subgrid subcycles the step at its own level, see iterateLocalTimestepRungeKutta.
+ * With --haloDepth, the halo holds a different number of stage evaluations than the scheme has stages. With a depth of
+ * 1, the halos are exchanged before every stage, see stagewiseRungeKuttaSequence. With a multiple m of the stages, they
+ * are exchanged every m steps, and the steps in between evaluate the halo left from the previous steps, see stageHalo.
+ * On the CPU, the first stage is evaluated on the interior of the subgrids, which does not depend on the halo, while the
+ * halos are exchanged. Its border and the remaining stages follow, see OVERLAPPED_SOLVER_SEQUENCE. The later stages are
+ * not overlapped, because their inputs share the buffer matrices, such that the border would read overwritten inputs.
+ */
+
+template <typename Tableau, PHOENIX::Type::uint32 Stage, bool evolve_reservoir>
+void PHOENIX::Solver::rungeKuttaStageInput( const Type::uint32 subgrid, KernelArguments& kernel_arguments, Type::stream_t& stream ) {
+    // The macros do not parenthesize their index.
+    constexpr Type::uint32 previous_stage = Stage - 1;
+    if constexpr ( Stage > 1 ) {
+        // Sum the input for this stage from row Stage-1 of the tableau.
+        [&]<Type::uint32... J>( std::integer_sequence<Type::uint32, J...> ) {
+            INTERMEDIATE_SUM_K_RESERVOIR( previous_stage, evolve_reservoir, Tableau::a[previous_stage][J]... );
+        }( std::make_integer_sequence<Type::uint32, previous_stage>{} );
+    }
+}
+
+template <typename Tableau, PHOENIX::Type::uint32 Stage, bool evolve_reservoir>
+void PHOENIX::Solver::rungeKuttaStageDerivative( const Type::uint32 subgrid, KernelArguments& kernel_arguments, Type::stream_t& stream ) {
+    constexpr Type::uint32 previous_stage = Stage - 1;
+    if constexpr ( Stage == 1 ) {
+        CALCULATE_K_INTO( 1, 0, wavefunction, reservoir, evolve_reservoir );
+    } else if constexpr ( evolve_reservoir ) {
+        CALCULATE_K_INTO( Stage, previous_stage, buffer_wavefunction, buffer_reservoir, true );
+    } else {
+        // The reservoir is fixed, so every stage couples to it directly
+        CALCULATE_K_INTO( Stage, previous_stage, buffer_wavefunction, reservoir, false );
+    }
+}
+
+template <typename Tableau, PHOENIX::Type::uint32 Stage, bool evolve_reservoir>
+void PHOENIX::Solver::rungeKuttaStage( const Type::uint32 subgrid, KernelArguments& kernel_arguments, Type::stream_t& stream ) {
+    rungeKuttaStageInput<Tableau, Stage, evolve_reservoir>( subgrid, kernel_arguments, stream );
+    rungeKuttaStageDerivative<Tableau, Stage, evolve_reservoir>( subgrid, kernel_arguments, stream );
+}
+
+template <typename Tableau, bool evolve_reservoir, PHOENIX::Type::uint32 first_stage>
+void PHOENIX::Solver::rungeKuttaSequence( const Type::uint32 subgrid, KernelArguments& kernel_arguments, Type::stream_t& stream ) {
+    [&]<Type::uint32... S>( std::integer_sequence<Type::uint32, S...> ) {
+        ( rungeKuttaStage<Tableau, S + first_stage, evolve_reservoir>( subgrid, kernel_arguments, stream ), ... );
+    }( std::make_integer_sequence<Type::uint32, Tableau::stages + 1 - first_stage>{} );
+
+    [&]<Type::uint32... J>( std::integer_sequence<Type::uint32, J...> ) {
+        FINAL_SUM_K_RESERVOIR( Tableau::stages, evolve_reservoir, Tableau::b[J]... );
+    }( std::make_integer_sequence<Type::uint32, Tableau::stages>{} );
+}
+
+/**
+ * The spectral Laplacian of a stage input needs the full grid, so every stage is split into the
+ * summation of its input on the subgrids, the FFT of the gathered input and the evaluation of its k,
+ * which reads the Laplacian from its k slot. The subgrid parts are not captured in CUDA graphs,
+ * because the FFTs in between are not.
+ */
+template <typename Tableau, PHOENIX::Type::uint32 Stage, bool evolve_reservoir>
+void PHOENIX::Solver::spectralRungeKuttaStage() {
+    if constexpr ( Stage > 1 ) {
+        SOLVER_SEQUENCE( false, rungeKuttaStageInput<GCC_EXPAND_VA_ARGS( Tableau, Stage, evolve_reservoir )>( subgrid, kernel_arguments, stream ); );
+    }
+    // The k of stage s is stored in slot s-1
+    spectralLaplacian( Stage == 1 ? matrix.wavefunction_plus : matrix.buffer_wavefunction_plus, Stage - 1 );
+    SOLVER_SEQUENCE( false, rungeKuttaStageDerivative<GCC_EXPAND_VA_ARGS( Tableau, Stage, evolve_reservoir )>( subgrid, kernel_arguments, stream ); );
+}
+
+template <typename Tableau, bool evolve_reservoir>
+void PHOENIX::Solver::spectralRungeKuttaSequence() {
+    [&]<Type::uint32... S>( std::integer_sequence<Type::uint32, S...> ) {
+        ( spectralRungeKuttaStage<Tableau, S + 1, evolve_reservoir>(), ... );
+    }( std::make_integer_sequence<Type::uint32, Tableau::stages>{} );
+
+    SOLVER_SEQUENCE( false,
+
+                     [&]<Type::uint32... J>( std::integer_sequence<Type::uint32, J...> ) {
+                         FINAL_SUM_K_RESERVOIR( Tableau::stages, evolve_reservoir, Tableau::b[J]... );
+                     }( std::make_integer_sequence<Type::uint32, Tableau::stages>{} );
+
+    );
+}
+
+/**
+ * Every stage is evaluated on the subgrids alone. The halos of its input are exchanged first, after which its k and
+ * the input of the next stage, or the final sum after the last stage, are evaluated in one pass over the subgrids.
+ * The reservoir is pointwise, so its halos are not needed.
+ */
+template <typename Tableau, PHOENIX::Type::uint32 Stage>
+void PHOENIX::Solver::stagewiseRungeKuttaStage() {
+    auto& input_plus = Stage == 1 ? matrix.wavefunction_plus : matrix.buffer_wavefunction_plus;
+    SYNCHRONIZE_HALOS( 0, input_plus.getSubgridDevicePtrs() );
+    if ( system.use_twin_mode ) {
+        auto& input_minus = Stage == 1 ? matrix.wavefunction_minus : matrix.buffer_wavefunction_minus;
+        SYNCHRONIZE_HALOS( 0, input_minus.getSubgridDevicePtrs() );
+    }
+    SUBGRID_SEQUENCE(
+
+        rungeKuttaStageDerivative<GCC_EXPAND_VA_ARGS( Tableau, Stage )>( subgrid, kernel_arguments, stream );
+        if constexpr ( Stage < Tableau::stages ) {
+            rungeKuttaStageInput<GCC_EXPAND_VA_ARGS( Tableau, Stage + 1 )>( subgrid, kernel_arguments, stream );
+        } else {
+            [&]<Type::uint32... J>( std::integer_sequence<Type::uint32, J...> ) {
+                FINAL_SUM_K_RESERVOIR( Tableau::stages, true, Tableau::b[J]... );
+            }( std::make_integer_sequence<Type::uint32, Tableau::stages>{} );
+        }
+
+    );
+}
+
+template <typename Tableau>
+void PHOENIX::Solver::stagewiseRungeKuttaSequence() {
+    [&]<Type::uint32... S>( std::integer_sequence<Type::uint32, S...> ) {
+        ( stagewiseRungeKuttaStage<Tableau, S + 1>(), ... );
+    }( std::make_integer_sequence<Type::uint32, Tableau::stages>{} );
+}
+
+void PHOENIX::Solver::spectralLaplacian( CUDAMatrix<Type::complex>& input, const Type::uint32 slot ) {
+    auto kernel_arguments = generateKernelArguments();
+    auto [block_size, grid_size] = getLaunchParameters( system.p.N_c, system.p.N_r );
+    auto& ptrs = kernel_arguments.dev_ptrs;
+
+    input.toFull( ptrs.buffer_fft_plus );
+    calculateFFT( ptrs.buffer_fft_plus, ptrs.fft_plus, FFT::forward );
+    CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_spectral_laplacian, "spectral_laplacian", grid_size, block_size, 0, kernel_arguments, ptrs.fft_plus );
+    calculateFFT( ptrs.fft_plus, ptrs.buffer_fft_plus, FFT::inverse );
+    matrix.k_wavefunction_plus.toSubgrids( ptrs.buffer_fft_plus, slot );
+}
+
+template <typename Tableau>
+void PHOENIX::Solver::iterateFixedTimestepRungeKutta() {
+    if ( system.local_timestep_levels > 0 ) {
+        iterateLocalTimestepRungeKutta<Tableau>();
+        return;
+    }
+
+    if ( system.use_reservoir and system.reservoir_subcycle > 1 ) {
+        if ( reservoir_cycle_steps == system.reservoir_subcycle )
+            completeReservoirCycle();
+        if ( reservoir_cycle_steps == 0 )
+            beginReservoirCycle();
+
+        if ( system.use_spectral_laplacian ) {
+            spectralRungeKuttaSequence<Tableau, false>();
+        } else {
+            OVERLAPPED_SOLVER_SEQUENCE( true /*Capture CUDA Graph*/,
+
+                                        rungeKuttaStage<GCC_EXPAND_VA_ARGS( Tableau, 1, false )>( subgrid, kernel_arguments, stream ),
+                                        rungeKuttaSequence<GCC_EXPAND_VA_ARGS( Tableau, false, 2 )>( subgrid, kernel_arguments, stream )
+
+            );
+        }
+        reservoir_cycle_steps++;
+        reservoir_cycle_time += system.p.dt;
+        return;
+    }
+
+    if ( system.use_spectral_laplacian ) {
+        spectralRungeKuttaSequence<Tableau>();
+        return;
+    }
+
+    if ( system.halo_depth == 1 ) {
+        stagewiseRungeKuttaSequence<Tableau>();
+        return;
+    }
+
+    // The halos are exchanged once the steps since the last exchange have consumed them, which is after every step by default
+    if ( halo_consumed == 0 ) {
+        OVERLAPPED_SOLVER_SEQUENCE( true /*Capture CUDA Graph*/,
+
+                                    rungeKuttaStage<GCC_EXPAND_VA_ARGS( Tableau, 1 )>( subgrid, kernel_arguments, stream ),
+                                    rungeKuttaSequence<GCC_EXPAND_VA_ARGS( Tableau, true, 2 )>( subgrid, kernel_arguments, stream )
+
+        );
+    } else {
+        SUBGRID_SEQUENCE( rungeKuttaSequence<Tableau>( subgrid, kernel_arguments, stream ); );
+    }
+    halo_consumed += Tableau::stages * system.p.stencil_radius;
+    if ( halo_consumed >= system.p.halo_size )
+        halo_consumed = 0;
+}
+
+/**
+ * The reservoir cycle spans reservoir_subcycle wavefunction steps. It is started with the current wavefunction,
+ * after which the reservoir holds its prediction for the middle of the cycle, and completed with the wavefunction
+ * at its end. A cycle is completed early if the physical reservoir is needed, e.g. for the output.
+ * The kernels are pointwise, so they are evaluated without halo. The halos are synchronized once per cycle.
+ */
+void PHOENIX::Solver::beginReservoirCycle() {
+    const Type::real cycle_time = system.reservoir_subcycle * system.p.dt;
+    const Type::uint32 current_halo = 0;
+    auto [block_size, grid_size] = getLaunchParameters( system.p.subgrid_N_c, system.p.subgrid_N_r );
+#pragma omp parallel for schedule( static )
+    for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {
+        auto kernel_arguments = generateKernelArguments( subgrid );
+        if ( system.use_twin_mode ) {
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_reservoir_cycle_begin<true>, "reservoir_cycle_begin", grid_size, block_size, 0, current_halo, kernel_arguments, cycle_time );
+        } else {
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_reservoir_cycle_begin<false>, "reservoir_cycle_begin", grid_size, block_size, 0, current_halo, kernel_arguments, cycle_time );
+        }
+    }
+    SYNCHRONIZE_HALOS( 0, matrix.reservoir_plus.getSubgridDevicePtrs() );
+    if ( system.use_twin_mode )
+        SYNCHRONIZE_HALOS( 0, matrix.reservoir_minus.getSubgridDevicePtrs() );
+    reservoir_cycle_time = 0.0;
+}
+
+void PHOENIX::Solver::completeReservoirCycle() {
+    if ( reservoir_cycle_steps == 0 )
+        return;
+    const Type::uint32 current_halo = 0;
+    auto [block_size, grid_size] = getLaunchParameters( system.p.subgrid_N_c, system.p.subgrid_N_r );
+#pragma omp parallel for schedule( static )
+    for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {
+        auto kernel_arguments = generateKernelArguments( subgrid );
+        if ( system.use_twin_mode ) {
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_reservoir_cycle_complete<true>, "reservoir_cycle_complete", grid_size, block_size, 0, current_halo, kernel_arguments, reservoir_cycle_time );
+        } else {
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Compute::gp_reservoir_cycle_complete<false>, "reservoir_cycle_complete", grid_size, block_size, 0, current_halo, kernel_arguments, reservoir_cycle_time );
+        }
+    }
+    reservoir_cycle_steps = 0;
+}
+
+/**
+ * Local time stepping. Every subgrid subcycles the step dt with dt / 2^l, where its level l follows from its local
+ * stability limit, see updateLocalTimestepLevels. The substeps of the finest level in use are processed in order.
+ * A subgrid of level l starts a local step every 2^(finest - l) substeps. Only then, its halos are synchronized,
+ * because all stages of a local step are evaluated from the halo as usual. Finer neighbours are at the same time,
+ * while coarser neighbours are within a step of their own. Their halo values are interpolated linearly in time
+ * between the state at the end of that step and the state at its beginning, which is kept in matrix.previous_*.
+ * The kernels of every level read their t and dt from local_timestep_time.
+ */
+template <typename Tableau>
+void PHOENIX::Solver::iterateLocalTimestepRungeKutta() {
+    const Type::uint32 subgrids = system.p.subgrids_columns * system.p.subgrids_rows;
+    if ( local_timestep_level.empty() ) {
+        matrix.previous_wavefunction_plus.construct( system.p.N_r, system.p.N_c, system.p.subgrids_columns, system.p.subgrids_rows, system.p.halo_size, "previous_wavefunction_plus" );
+        if ( system.use_reservoir )
+            matrix.previous_reservoir_plus.construct( system.p.N_r, system.p.N_c, system.p.subgrids_columns, system.p.subgrids_rows, system.p.halo_size, "previous_reservoir_plus" );
+        if ( system.use_twin_mode ) {
+            matrix.previous_wavefunction_minus.construct( system.p.N_r, system.p.N_c, system.p.subgrids_columns, system.p.subgrids_rows, system.p.halo_size, "previous_wavefunction_minus" );
+            if ( system.use_reservoir )
+                matrix.previous_reservoir_minus.construct( system.p.N_r, system.p.N_c, system.p.subgrids_columns, system.p.subgrids_rows, system.p.halo_size, "previous_reservoir_minus" );
+        }
+        updateLocalTimestepLevels();
+    } else if ( system.p.t >= local_timestep_update_t + system.output_every ) {
+        updateLocalTimestepLevels();
+    }
+
+    const Type::uint32 finest = *std::max_element( local_timestep_level.begin(), local_timestep_level.end() );
+    const Type::uint32 substeps = 1u << finest;
+    Type::host_vector<Type::real> level_time( 2 * ( finest + 1 ) );
+    Type::host_vector<Type::real> halo_weight( subgrids );
+    Type::host_vector<Type::uint32> active( subgrids );
+    std::vector<Type::uint32> active_subgrids;
+    const Type::uint32 current_halo = 0;
+    auto [block_size, grid_size] = getLaunchParameters( system.p.subgrid_N_c, system.p.subgrid_N_r );
+
+    for ( Type::uint32 n = 0; n < substeps; n++ ) {
+        for ( Type::uint32 l = 0; l <= finest; l++ ) {
+            level_time[2 * l] = system.p.t + n * system.p.dt / substeps;
+            level_time[2 * l + 1] = system.p.dt / Type::real( 1u << l );
+        }
+        active_subgrids.clear();
+        for ( Type::uint32 subgrid = 0; subgrid < subgrids; subgrid++ ) {
+            const Type::uint32 stride = 1u << ( finest - local_timestep_level[subgrid] );
+            active[subgrid] = n % stride == 0;
+            halo_weight[subgrid] = active[subgrid] ? Type::real( 1.0 ) : Type::real( n % stride ) / stride;
+            if ( active[subgrid] )
+                active_subgrids.push_back( subgrid );
+        }
+        local_timestep_time = level_time;
+        local_timestep_halo_weight = halo_weight;
+        local_timestep_active = active;
+
+        // Keep the state at the beginning of the local step for the halos of finer neighbours
+#pragma omp parallel for schedule( static )
+        for ( Type::uint32 a = 0; a < active_subgrids.size(); a++ ) {
+            const Type::uint32 subgrid = active_subgrids[a];
+            if ( local_timestep_level[subgrid] == finest )
+                continue;
+            auto kernel_arguments = generateKernelArguments( subgrid );
+            auto& ptrs = kernel_arguments.dev_ptrs;
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::copy_subgrid<Type::complex>, "local_timestep_keep", grid_size, block_size, 0, current_halo, kernel_arguments, matrix.previous_wavefunction_plus.getDevicePtr( subgrid ), ptrs.wavefunction_plus );
+            if ( system.use_reservoir )
+                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::copy_subgrid<Type::complex>, "local_timestep_keep", grid_size, block_size, 0, current_halo, kernel_arguments, matrix.previous_reservoir_plus.getDevicePtr( subgrid ), ptrs.reservoir_plus );
+            if ( system.use_twin_mode ) {
+                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::copy_subgrid<Type::complex>, "local_timestep_keep", grid_size, block_size, 0, current_halo, kernel_arguments, matrix.previous_wavefunction_minus.getDevicePtr( subgrid ), ptrs.wavefunction_minus );
+                if ( system.use_reservoir )
+                    CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::copy_subgrid<Type::complex>, "local_timestep_keep", grid_size, block_size, 0, current_halo, kernel_arguments, matrix.previous_reservoir_minus.getDevicePtr( subgrid ), ptrs.reservoir_minus );
+            }
+        }
+
+        SYNCHRONIZE_HALOS_INTERPOLATED( 0, matrix.wavefunction_plus.getSubgridDevicePtrs(), matrix.previous_wavefunction_plus.getSubgridDevicePtrs() );
+        if ( system.use_reservoir )
+            SYNCHRONIZE_HALOS_INTERPOLATED( 0, matrix.reservoir_plus.getSubgridDevicePtrs(), matrix.previous_reservoir_plus.getSubgridDevicePtrs() );
+        if ( system.use_twin_mode ) {
+            SYNCHRONIZE_HALOS_INTERPOLATED( 0, matrix.wavefunction_minus.getSubgridDevicePtrs(), matrix.previous_wavefunction_minus.getSubgridDevicePtrs() );
+            if ( system.use_reservoir )
+                SYNCHRONIZE_HALOS_INTERPOLATED( 0, matrix.reservoir_minus.getSubgridDevicePtrs(), matrix.previous_reservoir_minus.getSubgridDevicePtrs() );
+        }
+
+#pragma omp parallel for schedule( static )
+        for ( Type::uint32 a = 0; a < active_subgrids.size(); a++ ) {
+            const Type::uint32 subgrid = active_subgrids[a];
+            auto kernel_arguments = generateKernelArguments( subgrid );
+            kernel_arguments.time = GET_RAW_PTR( local_timestep_time ) + 2 * local_timestep_level[subgrid];
+            Type::stream_t stream{};
+            rungeKuttaSequence<Tableau>( subgrid, kernel_arguments, stream );
+        }
+    }
+}
+
+/**
+ * The level of a subgrid is the smallest l for which dt / 2^l keeps a margin of 10% to its estimated stability
+ * limit, see estimateStableTimestepPerSubgrid, which includes the halo and thus the dynamics about to enter.
+ * Neighbouring levels then differ by at most one, such that the interpolated halos span at most two substeps.
+ * The levels are reassigned every output interval.
+ */
+void PHOENIX::Solver::updateLocalTimestepLevels() {
+    const Type::uint32 columns = system.p.subgrids_columns;
+    const Type::uint32 rows = system.p.subgrids_rows;
+    const auto stable_dt = estimateStableTimestepPerSubgrid();
+    local_timestep_level.assign( columns * rows, 0 );
+    for ( Type::uint32 subgrid = 0; subgrid < columns * rows; subgrid++ ) {
+        Type::uint32 level = 0;
+        while ( level < system.local_timestep_levels and system.p.dt / Type::real( 1u << level ) > Type::real( 0.9 ) * stable_dt[subgrid] ) level++;
+        local_timestep_level[subgrid] = level;
+    }
+    bool changed = true;
+    while ( changed ) {
+        changed = false;
+        for ( int R = 0; R < int( rows ); R++ ) {
+            for ( int C = 0; C < int( columns ); C++ ) {
+                auto& level = local_timestep_level[R * columns + C];
+                for ( int dr = -1; dr <= 1; dr++ ) {
+                    for ( int dc = -1; dc <= 1; dc++ ) {
+                        int r = R + dr;
+                        int c = C + dc;
+                        if ( ( not system.p.periodic_boundary_y and ( r < 0 or r >= int( rows ) ) ) or ( not system.p.periodic_boundary_x and ( c < 0 or c >= int( columns ) ) ) )
+                            continue;
+                        r = ( r + rows ) % rows;
+                        c = ( c + columns ) % columns;
+                        const Type::uint32 neighbour = local_timestep_level[r * columns + c];
+                        if ( level + 1 < neighbour ) {
+                            level = neighbour - 1;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    local_timestep_update_t = system.p.t;
+}
+
+void PHOENIX::Solver::iterateFixedTimestepRungeKutta3() {
+    iterateFixedTimestepRungeKutta<RungeKutta::RK3>();
+}
+
+void PHOENIX::Solver::iterateFixedTimestepRungeKutta4() {
+    iterateFixedTimestepRungeKutta<RungeKutta::RK4>();
+}
+
+// Schemes registered in Solver::iterator
+template void PHOENIX::Solver::iterateFixedTimestepRungeKutta<PHOENIX::RungeKutta::Ralston>();
+template void PHOENIX::Solver::iterateFixedTimestepRungeKutta<PHOENIX::RungeKutta::SSPRK3>();
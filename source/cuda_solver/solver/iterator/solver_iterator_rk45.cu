@@ -0,0 +1,107 @@
+#include <omp.h>
+#include <cmath>
+#include <algorithm>
+
+// Include Cuda Kernel headers
+#include "cuda/typedef.cuh"
+#include "kernel/kernel_compute.cuh"
+#include "kernel/kernel_summation.cuh"
+#include "kernel/kernel_halo.cuh"
+#include "system/system_parameters.hpp"
+#include "cuda/cuda_matrix.cuh"
+#include "solver/gpu_solver.hpp"
+#include "misc/commandline_io.hpp"
+
+/*
+ * This function iterates the Runge Kutta Kernel using a variable time step.
+ * The embedded Dormand-Prince 5(4) method is used. The 5th order solution is
+ * propagated, while the difference to the embedded 4th order solution is
+ * used as the local error estimate:
+ * ------------------------------------------------------------------------------
+ * k1 = f(t, y)
+ * k2 = f(t + 1/5 dt, y + dt * (1/5 k1))
+ * k3 = f(t + 3/10 dt, y + dt * (3/40 k1 + 9/40 k2))
+ * k4 = f(t + 4/5 dt, y + dt * (44/45 k1 - 56/15 k2 + 32/9 k3))
+ * k5 = f(t + 8/9 dt, y + dt * (19372/6561 k1 - 25360/2187 k2 + 64448/6561 k3 - 212/729 k4))
+ * k6 = f(t + dt, y + dt * (9017/3168 k1 - 355/33 k2 + 46732/5247 k3 + 49/176 k4 - 5103/18656 k5))
+ * next = y + dt * (35/384 k1 + 500/1113 k3 + 125/192 k4 - 2187/6784 k5 + 11/84 k6)
+ * k7 = f(t + dt, next)
+ * error = dt * (71/57600 k1 - 71/16695 k3 + 71/1920 k4 - 17253/339200 k5 + 22/525 k6 - 1/40 k7)
+ * ------------------------------------------------------------------------------
+ * The error norm is the maximum of |error| over all subgrids, relative to the
+ * maximum of |Psi|. If it exceeds the tolerance, the step is repeated with a
+ * smaller dt. Accepted steps propose the next dt, which main() picks up through
+ * adaptive_dt. dt is always kept within [dt_min, dt_max].
+ */
+
+void PHOENIX::Solver::iterateVariableTimestepRungeKutta() {
+    // Safety factor and bounds of the step size controller
+    const Type::real safety = 0.9;
+    const Type::real min_factor = 0.2;
+    const Type::real max_factor = 5.0;
+
+    bool accepted = false;
+    while ( not accepted ) {
+        SOLVER_SEQUENCE( true /*Capture CUDA Graph*/,
+
+                         CALCULATE_K( 1, wavefunction, reservoir );
+
+                         INTERMEDIATE_SUM_K( 1, 1.0f / 5.0f );
+
+                         CALCULATE_K( 2, buffer_wavefunction, buffer_reservoir );
+
+                         INTERMEDIATE_SUM_K( 2, 3.0f / 40.0f, 9.0f / 40.0f );
+
+                         CALCULATE_K( 3, buffer_wavefunction, buffer_reservoir );
+
+                         INTERMEDIATE_SUM_K( 3, 44.0f / 45.0f, -56.0f / 15.0f, 32.0f / 9.0f );
+
+                         CALCULATE_K( 4, buffer_wavefunction, buffer_reservoir );
+
+                         INTERMEDIATE_SUM_K( 4, 19372.0f / 6561.0f, -25360.0f / 2187.0f, 64448.0f / 6561.0f, -212.0f / 729.0f );
+
+                         CALCULATE_K( 5, buffer_wavefunction, buffer_reservoir );
+
+                         INTERMEDIATE_SUM_K( 5, 9017.0f / 3168.0f, -355.0f / 33.0f, 46732.0f / 5247.0f, 49.0f / 176.0f, -5103.0f / 18656.0f );
+
+                         CALCULATE_K( 6, buffer_wavefunction, buffer_reservoir );
+
+                         INTERMEDIATE_SUM_K( 6, 35.0f / 384.0f, 0.0f, 500.0f / 1113.0f, 125.0f / 192.0f, -2187.0f / 6784.0f, 11.0f / 84.0f );
+
+                         CALCULATE_K( 7, buffer_wavefunction, buffer_reservoir );
+
+                         ERROR_K( 7, 71.0f / 57600.0f, 0.0f, -71.0f / 16695.0f, 71.0f / 1920.0f, -17253.0f / 339200.0f, 22.0f / 525.0f, -1.0f / 40.0f );
+
+        );
+
+        // Parallel max reduction of the error norm. rk_error holds |error|^2, summed over both components in TE/TM mode.
+        const Type::real error_max = matrix.rk_error.transformMax( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::real( a ); } );
+        Type::real psi_max = matrix.wavefunction_plus.transformMax( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::abs2( a ); } );
+        if ( system.use_twin_mode )
+            psi_max = std::max( psi_max, matrix.wavefunction_minus.transformMax( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::abs2( a ); } ) );
+        const Type::real error = std::sqrt( error_max / std::max( psi_max, Type::real( 1E-30 ) ) );
+
+        // Standard step size controller for a 5(4) pair. A NaN error is treated as a failed step.
+        Type::real factor = error > 0.0 ? safety * std::pow( system.tolerance / error, Type::real( 0.2 ) ) : max_factor;
+        factor = std::isfinite( factor ) ? std::clamp( factor, min_factor, max_factor ) : min_factor;
+
+        accepted = ( error <= system.tolerance ) or system.p.dt <= system.dt_min;
+        if ( accepted ) {
+            // The step is accepted. Propose the next dt.
+            adaptive_dt = std::clamp( system.p.dt * factor, system.dt_min, system.dt_max );
+            break;
+        }
+
+        // The step is rejected. Retry with a smaller dt.
+        system.p.dt = std::max( system.p.dt * factor, system.dt_min );
+        Type::host_vector<Type::real> new_time = { system.p.t, system.p.dt };
+        time = new_time;
+    }
+
+    // Accept the 5th order solution
+    SOLVER_SEQUENCE( false /*Capture CUDA Graph*/,
+
+                     FINAL_SUM_K( 6, 35.0f / 384.0f, 0.0f, 500.0f / 1113.0f, 125.0f / 192.0f, -2187.0f / 6784.0f, 11.0f / 84.0f );
+
+    );
+}
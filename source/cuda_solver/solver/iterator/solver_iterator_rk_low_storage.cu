@@ -0,0 +1,85 @@
+#include <omp.h>
+#include <utility>
+
+// Include Cuda Kernel headers
+#include "cuda/typedef.cuh"
+#include "kernel/kernel_compute.cuh"
+#include "kernel/kernel_summation.cuh"
+#include "kernel/kernel_halo.cuh"
+#include "system/system_parameters.hpp"
+#include "cuda/cuda_matrix.cuh"
+#include "solver/gpu_solver.hpp"
+#include "solver/runge_kutta_tableau.hpp"
+#include "misc/commandline_io.hpp"
+
+/*
+ * These functions iterate a low storage (2N) Runge Kutta scheme using a fixed time step.
+ * The scheme is given in Williamson form by the coefficients A and B, see runge_kutta_tableau.hpp:
+ * ------------------------------------------------------------------------------
+ * for s = 1 ... stages:
+ *     k = f(t, y) = rungeFuncKernel(current)
+ *     increment = A_s * increment + dt * k
+ *     current = current + B_s * increment
+ * ------------------------------------------------------------------------------
+ * The wavefunction and reservoir are updated in place. The increment register uses the buffer
+ * matrices, so only a single k matrix per field is required, compared to four for the classical RK4.
+ * Every stage shrinks the valid region by one cell, hence the halo equals the number of stages.
+ */
+
+template <float A, float B, bool include_dw, bool include_reservoir>
+void PHOENIX::Solver::lowStorageUpdate( KernelArguments& kernel_arguments, Type::stream_t& stream, const Type::uint32 current_halo, Type::complex* state, Type::complex* k, Type::complex* increment ) {
+    auto [current_block, current_grid] = getLaunchParameters( system.p.subgrid_N_c + 2 * current_halo, system.p.subgrid_N_r + 2 * current_halo );
+    if ( system.imag_time_amplitude == 0.0 ) {
+        CALL_SUBGRID_KERNEL( Kernel::Summation::runge_low_storage_update<GCC_EXPAND_VA_ARGS( Type::complex, false, include_dw, include_reservoir, A, B )>, "Low Storage Update", current_grid, current_block, stream, current_halo, kernel_arguments, state, k, increment );
+    } else {
+        CALL_SUBGRID_KERNEL( Kernel::Summation::runge_low_storage_update<GCC_EXPAND_VA_ARGS( Type::complex, true, include_dw, include_reservoir, A, B )>, "Low Storage Update", current_grid, current_block, stream, current_halo, kernel_arguments, state, k, increment );
+    }
+}
+
+template <typename Tableau, PHOENIX::Type::uint32 Stage>
+void PHOENIX::Solver::lowStorageRungeKuttaStage( const Type::uint32 subgrid, KernelArguments& kernel_arguments, Type::stream_t& stream ) {
+    constexpr float A = Tableau::A[Stage - 1];
+    constexpr float B = Tableau::B[Stage - 1];
+
+    // Every stage writes into the same k slot
+    CALCULATE_K_INTO( Stage, 0, wavefunction, reservoir, true );
+
+    const Type::uint32 current_halo = system.p.halo_size - Stage * system.p.stencil_radius;
+    if ( system.use_stochastic ) {
+        if ( system.use_reservoir )
+            lowStorageUpdate<A, B, true, true>( kernel_arguments, stream, current_halo, matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.k_wavefunction_plus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_plus.getDevicePtr( subgrid ) );
+        else
+            lowStorageUpdate<A, B, true, false>( kernel_arguments, stream, current_halo, matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.k_wavefunction_plus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_plus.getDevicePtr( subgrid ) );
+    } else {
+        lowStorageUpdate<A, B, false, false>( kernel_arguments, stream, current_halo, matrix.wavefunction_plus.getDevicePtr( subgrid ), matrix.k_wavefunction_plus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_plus.getDevicePtr( subgrid ) );
+    }
+    if ( system.use_reservoir )
+        lowStorageUpdate<A, B, false, false>( kernel_arguments, stream, current_halo, matrix.reservoir_plus.getDevicePtr( subgrid ), matrix.k_reservoir_plus.getDevicePtr( subgrid ), matrix.buffer_reservoir_plus.getDevicePtr( subgrid ) );
+    if ( not system.use_twin_mode )
+        return;
+
+    if ( system.use_stochastic ) {
+        if ( system.use_reservoir )
+            lowStorageUpdate<A, B, true, true>( kernel_arguments, stream, current_halo, matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.k_wavefunction_minus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_minus.getDevicePtr( subgrid ) );
+        else
+            lowStorageUpdate<A, B, true, false>( kernel_arguments, stream, current_halo, matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.k_wavefunction_minus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_minus.getDevicePtr( subgrid ) );
+    } else {
+        lowStorageUpdate<A, B, false, false>( kernel_arguments, stream, current_halo, matrix.wavefunction_minus.getDevicePtr( subgrid ), matrix.k_wavefunction_minus.getDevicePtr( subgrid ), matrix.buffer_wavefunction_minus.getDevicePtr( subgrid ) );
+    }
+    if ( system.use_reservoir )
+        lowStorageUpdate<A, B, false, false>( kernel_arguments, stream, current_halo, matrix.reservoir_minus.getDevicePtr( subgrid ), matrix.k_reservoir_minus.getDevicePtr( subgrid ), matrix.buffer_reservoir_minus.getDevicePtr( subgrid ) );
+}
+
+template <typename Tableau>
+void PHOENIX::Solver::iterateFixedTimestepLowStorageRungeKutta() {
+    SOLVER_SEQUENCE( true /*Capture CUDA Graph*/,
+
+                     [&]<Type::uint32... S>( std::integer_sequence<Type::uint32, S...> ) {
+                         ( lowStorageRungeKuttaStage<Tableau, S + 1>( subgrid, kernel_arguments, stream ), ... );
+                     }( std::make_integer_sequence<Type::uint32, Tableau::stages>{} );
+
+    );
+}
+
+// Schemes registered in Solver::iterator
+template void PHOENIX::Solver::iterateFixedTimestepLowStorageRungeKutta<PHOENIX::RungeKutta::LowStorageRK4>();
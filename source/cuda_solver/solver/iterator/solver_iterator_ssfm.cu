@@ -1,4 +1,5 @@
 #include <omp.h>
+#include <algorithm>
 
 // Include Cuda Kernel headers
 #include "cuda/typedef.cuh"
@@ -9,54 +10,126 @@
 #include "misc/commandline_io.hpp"
 
 /**
- * Split Step Fourier Method
+ * Builds the k-space propagators of the linear steps, one for every fraction of dt. This is only
+ * done on first use or when dt or the fractions changed. If the FFT filter would be applied every
+ * step anyway, the FFT mask is folded into the half (square root of the mask) and full step
+ * propagators, and iterate() no longer applies it separately. Because the propagators are shared
+ * by both components, this is only done for the scalar model and for schemes that only use half
+ * and full steps. Iterators that propagate more than the wavefunction, e.g. the RK stages of the
+ * integrating factor RK4, disable the folding with fold_mask = false.
  */
-void PHOENIX::Solver::iterateSplitStepFourier() {
-    // TODO: im cudamacro.cuh soll ein choose_kernel macro stehen -> der wählt dann die template parameter aus. die einzelfunktionen dann auch templated!!
+void PHOENIX::Solver::updateFourierPropagator( const std::vector<Type::real>& fractions, const bool fold_mask ) {
+    if ( system.p.dt == fourier_propagator_dt and fractions == fourier_propagator_fractions )
+        return;
+    fourier_propagator_dt = system.p.dt;
+    fourier_propagator_fractions = fractions;
+    if ( matrix.fft_propagator.size() != fractions.size() * getFourierPropagatorSize() )
+        matrix.fft_propagator = Type::device_vector<Type::complex>( fractions.size() * getFourierPropagatorSize() );
+
+    const bool only_half_and_full_steps = std::ranges::all_of( fractions, []( Type::real f ) { return f == Type::real( 0.5 ) or f == Type::real( 1.0 ); } );
+    fft_mask_in_propagator = fold_mask and system.fft_mask.size() > 0 and system.fft_every <= system.p.dt and not system.use_twin_mode and only_half_and_full_steps;
+
     auto kernel_arguments = generateKernelArguments();
     auto [block_size, grid_size] = getLaunchParameters( system.p.N_c, system.p.N_r );
-    // Liner Half Step
-    // Calculate the FFT of Psi
-    calculateFFT( kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.fft_plus, FFT::forward );
-    if ( system.use_twin_mode )
-        calculateFFT( kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.fft_minus, FFT::forward );
+    for ( Type::uint32 f = 0; f < fractions.size(); f++ ) {
+        Type::real* mask = fft_mask_in_propagator ? kernel_arguments.dev_ptrs.fft_mask_plus : nullptr;
+        if ( system.use_twin_mode ) {
+            CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_linear_fourier_propagator<true>, "linear_propagator", grid_size, block_size, 0, kernel_arguments, fractions[f] * system.p.dt, mask, fractions[f] < Type::real( 1.0 ), getFourierPropagator( f ) );
+        } else {
+            CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_linear_fourier_propagator<false>, "linear_propagator", grid_size, block_size, 0, kernel_arguments, fractions[f] * system.p.dt, mask, fractions[f] < Type::real( 1.0 ), getFourierPropagator( f ) );
+        }
+    }
+}
+
+/**
+ * Linear step of the SSFM. Transforms in, multiplies with the given propagator and transforms
+ * back. matrix.fft then holds the linearly evolved wavefunction in real space. Both components
+ * are stacked in matrix.fft and matrix.buffer_fft, such that every transform is a single batched FFT.
+ */
+void PHOENIX::Solver::splitStepLinear( KernelArguments& kernel_arguments, Type::complex* in, Type::complex* propagator ) {
+    auto& ptrs = kernel_arguments.dev_ptrs;
+    auto [block_size, grid_size] = getLaunchParameters( system.p.N_c, system.p.N_r );
+    const Type::uint32 batch = system.use_twin_mode ? 2 : 1;
+
+    calculateFFT( in, ptrs.fft_plus, FFT::forward, batch );
     if ( system.use_twin_mode ) {
-        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_linear_fourier<true>, "linear_half_step", grid_size, block_size, 0, kernel_arguments, { kernel_arguments.dev_ptrs.fft_plus, kernel_arguments.dev_ptrs.fft_minus, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.discard } );
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_linear_fourier_cached<true>, "linear_step", grid_size, block_size, 0, kernel_arguments, { ptrs.fft_plus, ptrs.fft_minus, ptrs.discard, ptrs.discard, ptrs.buffer_fft_plus, ptrs.buffer_fft_minus, ptrs.discard, ptrs.discard }, propagator );
     } else {
-        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_linear_fourier<false>, "linear_half_step", grid_size, block_size, 0, kernel_arguments, { kernel_arguments.dev_ptrs.fft_plus, kernel_arguments.dev_ptrs.fft_minus, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.discard } );
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_linear_fourier_cached<false>, "linear_step", grid_size, block_size, 0, kernel_arguments, { ptrs.fft_plus, ptrs.fft_minus, ptrs.discard, ptrs.discard, ptrs.buffer_fft_plus, ptrs.buffer_fft_minus, ptrs.discard, ptrs.discard }, propagator );
     }
-    // Transform back. WF now holds the half-stepped wavefunction.
-    calculateFFT( kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.fft_plus, FFT::inverse );
-    if ( system.use_twin_mode )
-        calculateFFT( kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.fft_minus, FFT::inverse );
+    calculateFFT( ptrs.buffer_fft_plus, ptrs.fft_plus, FFT::inverse, batch );
+}
+
+/**
+ * Gathers Psi into the stacked buffer. Without TE/TM, the wavefunction can be transformed directly.
+ */
+PHOENIX::Type::complex* PHOENIX::Solver::splitStepGather( KernelArguments& kernel_arguments ) {
+    auto& ptrs = kernel_arguments.dev_ptrs;
+    if ( not system.use_twin_mode )
+        return ptrs.wavefunction_plus;
+    matrix.wavefunction_plus.toFull( ptrs.buffer_fft_plus );
+    matrix.wavefunction_minus.toFull( ptrs.buffer_fft_minus );
+    return ptrs.buffer_fft_plus;
+}
+
+/**
+ * Split Step Fourier Method
+ * Strang splitting L(dt/2) N(dt) L(dt/2). With -ssfmFused, the trailing L(dt/2) of one step
+ * and the leading L(dt/2) of the next step are merged into a single L(dt), halving the number
+ * of FFTs. The trailing half step is then kept pending until completeSplitStep() is called.
+ */
+void PHOENIX::Solver::iterateSplitStepFourier() {
+    // A pending half step belongs to the previous dt, so it has to be completed before the propagators change
+    if ( system.p.dt != fourier_propagator_dt )
+        completeSplitStep();
+    if ( system.ssfm_fused )
+        updateFourierPropagator( { 0.5, 1.0 } );
+    else
+        updateFourierPropagator( { 0.5 } );
+
+    // TODO: im cudamacro.cuh soll ein choose_kernel macro stehen -> der wählt dann die template parameter aus. die einzelfunktionen dann auch templated!!
+    auto kernel_arguments = generateKernelArguments();
+    auto [block_size, grid_size] = getLaunchParameters( system.p.N_c, system.p.N_r );
+    auto& ptrs = kernel_arguments.dev_ptrs;
+
+    // Linear (Half) Step. If the previous half step is pending, it is merged into this one.
+    splitStepLinear( kernel_arguments, splitStepGather( kernel_arguments ), getFourierPropagator( split_step_pending ? 1 : 0 ) );
 
     // Nonlinear Full Step
     if ( system.use_twin_mode ) {
-        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear<true>, "nonlinear_full_step", grid_size, block_size, 0, kernel_arguments, { kernel_arguments.dev_ptrs.fft_plus, kernel_arguments.dev_ptrs.fft_minus, kernel_arguments.dev_ptrs.reservoir_plus, kernel_arguments.dev_ptrs.reservoir_minus, kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.buffer_reservoir_plus, kernel_arguments.dev_ptrs.buffer_reservoir_minus } );
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear<true>, "nonlinear_full_step", grid_size, block_size, 0, kernel_arguments, { ptrs.fft_plus, ptrs.fft_minus, ptrs.reservoir_plus, ptrs.reservoir_minus, ptrs.buffer_fft_plus, ptrs.buffer_fft_minus, ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus } );
     } else {
-        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear<false>, "nonlinear_full_step", grid_size, block_size, 0, kernel_arguments, { kernel_arguments.dev_ptrs.fft_plus, kernel_arguments.dev_ptrs.fft_minus, kernel_arguments.dev_ptrs.reservoir_plus, kernel_arguments.dev_ptrs.reservoir_minus, kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.buffer_reservoir_plus, kernel_arguments.dev_ptrs.buffer_reservoir_minus } );
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear<false>, "nonlinear_full_step", grid_size, block_size, 0, kernel_arguments, { ptrs.fft_plus, ptrs.fft_minus, ptrs.reservoir_plus, ptrs.reservoir_minus, ptrs.buffer_fft_plus, ptrs.buffer_fft_minus, ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus } );
     }
-    // WF now holds the nonlinearly evolved wavefunction.
+    // The FFT buffer now holds the nonlinearly evolved wavefunction.
 
-    // Liner Half Step
-    // Calculate the FFT of Psi
-    calculateFFT( kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.fft_plus, FFT::forward );
-    if ( system.use_twin_mode )
-        calculateFFT( kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.fft_minus, FFT::forward );
-    if ( system.use_twin_mode ) {
-        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_linear_fourier<true>, "linear_half_step", grid_size, block_size, 0, kernel_arguments, { kernel_arguments.dev_ptrs.fft_plus, kernel_arguments.dev_ptrs.fft_minus, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.discard } );
+    Type::complex* result = ptrs.buffer_fft_plus;
+    Type::complex* result_minus = ptrs.buffer_fft_minus;
+    if ( system.ssfm_fused ) {
+        split_step_pending = true;
     } else {
-        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_linear_fourier<false>, "linear_half_step", grid_size, block_size, 0, kernel_arguments, { kernel_arguments.dev_ptrs.fft_plus, kernel_arguments.dev_ptrs.fft_minus, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.discard, kernel_arguments.dev_ptrs.discard } );
+        // Linear Half Step
+        splitStepLinear( kernel_arguments, ptrs.buffer_fft_plus, getFourierPropagator( 0 ) );
+        result = ptrs.fft_plus;
+        result_minus = ptrs.fft_minus;
     }
-    // Transform back. WF now holds the half-stepped wavefunction.
-    calculateFFT( kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.fft_plus, FFT::inverse );
-    if ( system.use_twin_mode )
-        calculateFFT( kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.fft_minus, FFT::inverse );
 
     if ( system.use_twin_mode ) {
-        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_independent<true>, "independent", grid_size, block_size, 0, kernel_arguments, { kernel_arguments.dev_ptrs.fft_plus, kernel_arguments.dev_ptrs.fft_minus, kernel_arguments.dev_ptrs.buffer_reservoir_plus, kernel_arguments.dev_ptrs.buffer_reservoir_minus, kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.reservoir_plus, kernel_arguments.dev_ptrs.reservoir_minus } );
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_independent<true>, "independent", grid_size, block_size, 0, kernel_arguments, { result, result_minus, ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus, ptrs.wavefunction_plus, ptrs.wavefunction_minus, ptrs.reservoir_plus, ptrs.reservoir_minus } );
     } else {
-        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_independent<false>, "independent", grid_size, block_size, 0, kernel_arguments, { kernel_arguments.dev_ptrs.fft_plus, kernel_arguments.dev_ptrs.fft_minus, kernel_arguments.dev_ptrs.buffer_reservoir_plus, kernel_arguments.dev_ptrs.buffer_reservoir_minus, kernel_arguments.dev_ptrs.wavefunction_plus, kernel_arguments.dev_ptrs.wavefunction_minus, kernel_arguments.dev_ptrs.reservoir_plus, kernel_arguments.dev_ptrs.reservoir_minus } );
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_independent<false>, "independent", grid_size, block_size, 0, kernel_arguments, { result, result_minus, ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus, ptrs.wavefunction_plus, ptrs.wavefunction_minus, ptrs.reservoir_plus, ptrs.reservoir_minus } );
     }
     // WF now holds the new result
-}
\ No newline at end of file
+}
+
+void PHOENIX::Solver::completeSplitStep() {
+    if ( not split_step_pending )
+        return;
+    split_step_pending = false;
+
+    auto kernel_arguments = generateKernelArguments();
+    splitStepLinear( kernel_arguments, splitStepGather( kernel_arguments ), getFourierPropagator( 0 ) );
+    matrix.wavefunction_plus.toSubgrids( kernel_arguments.dev_ptrs.fft_plus );
+    if ( system.use_twin_mode )
+        matrix.wavefunction_minus.toSubgrids( kernel_arguments.dev_ptrs.fft_minus );
+}
@@ -0,0 +1,71 @@
+#include <omp.h>
+#include <cmath>
+
+// Include Cuda Kernel headers
+#include "cuda/typedef.cuh"
+#include "kernel/kernel_compute.cuh"
+#include "system/system_parameters.hpp"
+#include "cuda/cuda_matrix.cuh"
+#include "solver/gpu_solver.hpp"
+#include "misc/commandline_io.hpp"
+
+/**
+ * Fourth order Split Step Fourier Method using the Forest-Ruth (Yoshida triple jump) splitting
+ * L(c1) N(d1) L(c2) N(d2) L(c2) N(d1) L(c1) with
+ * theta = 1/(2-2^(1/3)), c1 = theta/2, c2 = (1-theta)/2, d1 = theta, d2 = 1-2*theta.
+ * d2 and c2 are negative, so the dissipative parts of the nonlinear step are amplified during
+ * the second substep. This scheme is meant for conservative or weakly dissipative systems.
+ * The pulse, stochastic and reservoir swap (independent) parts are applied once per step.
+ */
+void PHOENIX::Solver::iterateSplitStepFourier4() {
+    const Type::real theta = Type::real( 1.0 ) / ( Type::real( 2.0 ) - std::cbrt( Type::real( 2.0 ) ) );
+    const Type::real c1 = theta / Type::real( 2.0 );
+    const Type::real c2 = ( Type::real( 1.0 ) - theta ) / Type::real( 2.0 );
+    const Type::real d1 = theta;
+    const Type::real d2 = Type::real( 1.0 ) - Type::real( 2.0 ) * theta;
+
+    updateFourierPropagator( { c1, c2 } );
+
+    // {t, dt} for the three nonlinear substeps
+    const Type::real t = system.p.t;
+    const Type::real dt = system.p.dt;
+    Type::host_vector<Type::real> new_substep_time = { t + c1 * dt, d1 * dt, t + ( c1 + d1 + c2 ) * dt, d2 * dt, t + ( Type::real( 1.0 ) - c1 ) * dt, d1 * dt };
+    substep_time = new_substep_time;
+
+    auto kernel_arguments = generateKernelArguments();
+    auto [block_size, grid_size] = getLaunchParameters( system.p.N_c, system.p.N_r );
+    auto& ptrs = kernel_arguments.dev_ptrs;
+
+    // The reservoir alternates between reservoir and buffer_reservoir and ends up in the buffer, like for the Strang splitting
+    Type::complex* reservoir_plus[2] = { ptrs.reservoir_plus, ptrs.buffer_reservoir_plus };
+    Type::complex* reservoir_minus[2] = { ptrs.reservoir_minus, ptrs.buffer_reservoir_minus };
+
+    Type::complex* in = splitStepGather( kernel_arguments );
+    for ( int substep = 0; substep < 3; substep++ ) {
+        // Linear Step with c1, c2, c2. matrix.fft holds the result.
+        splitStepLinear( kernel_arguments, in, getFourierPropagator( substep == 0 ? 0 : 1 ) );
+
+        // Nonlinear Step with the weighted substep time
+        auto substep_arguments = kernel_arguments;
+        substep_arguments.time = GET_RAW_PTR( substep_time ) + 2 * substep;
+        Type::complex* rv_in_plus = reservoir_plus[substep % 2];
+        Type::complex* rv_in_minus = reservoir_minus[substep % 2];
+        Type::complex* rv_out_plus = reservoir_plus[( substep + 1 ) % 2];
+        Type::complex* rv_out_minus = reservoir_minus[( substep + 1 ) % 2];
+        if ( system.use_twin_mode ) {
+            CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear<true>, "nonlinear_substep", grid_size, block_size, 0, substep_arguments, { ptrs.fft_plus, ptrs.fft_minus, rv_in_plus, rv_in_minus, ptrs.buffer_fft_plus, ptrs.buffer_fft_minus, rv_out_plus, rv_out_minus } );
+        } else {
+            CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_nonlinear<false>, "nonlinear_substep", grid_size, block_size, 0, substep_arguments, { ptrs.fft_plus, ptrs.fft_minus, rv_in_plus, rv_in_minus, ptrs.buffer_fft_plus, ptrs.buffer_fft_minus, rv_out_plus, rv_out_minus } );
+        }
+        in = ptrs.buffer_fft_plus;
+    }
+    // Final Linear Step with c1
+    splitStepLinear( kernel_arguments, in, getFourierPropagator( 0 ) );
+
+    if ( system.use_twin_mode ) {
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_independent<true>, "independent", grid_size, block_size, 0, kernel_arguments, { ptrs.fft_plus, ptrs.fft_minus, ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus, ptrs.wavefunction_plus, ptrs.wavefunction_minus, ptrs.reservoir_plus, ptrs.reservoir_minus } );
+    } else {
+        CALL_FULL_KERNEL( PHOENIX::Kernel::Compute::gp_scalar_independent<false>, "independent", grid_size, block_size, 0, kernel_arguments, { ptrs.fft_plus, ptrs.fft_minus, ptrs.buffer_reservoir_plus, ptrs.buffer_reservoir_minus, ptrs.wavefunction_plus, ptrs.wavefunction_minus, ptrs.reservoir_plus, ptrs.reservoir_minus } );
+    }
+    // WF now holds the new result
+}
@@ -7,6 +7,17 @@
 void PHOENIX::Solver::cacheValues() {
     // System Time
     cache_map_scalar["t"].emplace_back( system.p.t );
+    if ( system.auto_timestep > 0.0 )
+        cache_map_scalar["dt"].emplace_back( system.p.dt );
+    // Average number of substeps of the subgrids per step with local time stepping
+    if ( system.local_timestep_levels > 0 and not local_timestep_level.empty() ) {
+        Type::real substeps = 0.0;
+        for ( const auto level : local_timestep_level ) substeps += Type::real( 1u << level );
+        cache_map_scalar["substeps"].emplace_back( substeps / local_timestep_level.size() );
+    }
+    // Number of parareal iterations of the current window
+    if ( system.parareal_slices > 0 )
+        cache_map_scalar["parareal_iterations"].emplace_back( parareal_iterations );
 
     // Min and Max
     auto [min_plus, max_plus] = matrix.wavefunction_plus.extrema();
@@ -0,0 +1,86 @@
+#include <map>
+#include <functional>
+#include "cuda/typedef.cuh"
+#include "kernel/kernel_summation.cuh"
+#include "solver/gpu_solver.hpp"
+#include "solver/runge_kutta_tableau.hpp"
+
+/*
+ * The fixed timestep RK iterators keep the k's of the last step until the next step is started. From these,
+ * the continuous extension of the scheme interpolates the state at any time within the step, see
+ * RungeKutta::denseWeights, such that the output is produced at the exact output times while the integration
+ * keeps its dt. The interpolation only holds if the step is given by its k's alone. The stochastic noise, the
+ * normalization of the imaginary time propagation, the FFT mask and the subcycled reservoir change the state
+ * outside of the k's, and with local time stepping, the k's belong to the last substep of every subgrid. These
+ * fall back to shrinking dt to the output times, as do the other iterators.
+ */
+
+template <typename Tableau>
+static PHOENIX::Solver::DenseOutputWeights denseOutputWeights( const PHOENIX::Type::real theta ) {
+    const auto b_theta = PHOENIX::RungeKutta::denseWeights<Tableau>( theta );
+    PHOENIX::Solver::DenseOutputWeights weights;
+    weights.stages = Tableau::stages;
+    for ( PHOENIX::Type::uint32 s = 0; s < Tableau::stages; s++ ) weights.w[s] = Tableau::b[s] - b_theta[s];
+    return weights;
+}
+
+static const std::map<std::string, std::function<PHOENIX::Solver::DenseOutputWeights( PHOENIX::Type::real )>> dense_output_weights = { { "ralston", denseOutputWeights<PHOENIX::RungeKutta::Ralston> }, { "rk3", denseOutputWeights<PHOENIX::RungeKutta::RK3> }, { "ssprk3", denseOutputWeights<PHOENIX::RungeKutta::SSPRK3> }, { "rk4", denseOutputWeights<PHOENIX::RungeKutta::RK4> } };
+
+bool PHOENIX::Solver::supportsDenseOutput() {
+    if ( not dense_output_weights.contains( system.iterator ) )
+        return false;
+    if ( system.use_stochastic or system.imag_time_amplitude != 0.0 or system.use_fft_mask )
+        return false;
+    if ( system.local_timestep_levels > 0 )
+        return false;
+    return not( system.use_reservoir and system.reservoir_subcycle > 1 );
+}
+
+void PHOENIX::Solver::beginDenseOutput( const Type::real t ) {
+    // The output time is the end of the step
+    const Type::real theta = Type::real( 1.0 ) - ( system.p.t - t ) / system.p.dt;
+    if ( dense_output_active or theta >= 1.0 )
+        return;
+    const DenseOutputWeights weights = dense_output_weights.at( system.iterator )( theta );
+
+    const Type::uint32 current_halo = 0;
+    auto [block_size, grid_size] = getLaunchParameters( system.p.subgrid_N_c, system.p.subgrid_N_r );
+#pragma omp parallel for schedule( static )
+    for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {
+        auto kernel_arguments = generateKernelArguments( subgrid );
+        auto& ptrs = kernel_arguments.dev_ptrs;
+        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::runge_dense_output<Type::complex>, "dense_output", grid_size, block_size, 0, current_halo, kernel_arguments, weights, ptrs.wavefunction_plus, ptrs.buffer_wavefunction_plus, ptrs.k_wavefunction_plus );
+        if ( system.use_reservoir )
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::runge_dense_output<Type::complex>, "dense_output", grid_size, block_size, 0, current_halo, kernel_arguments, weights, ptrs.reservoir_plus, ptrs.buffer_reservoir_plus, ptrs.k_reservoir_plus );
+        if ( system.use_twin_mode ) {
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::runge_dense_output<Type::complex>, "dense_output", grid_size, block_size, 0, current_halo, kernel_arguments, weights, ptrs.wavefunction_minus, ptrs.buffer_wavefunction_minus, ptrs.k_wavefunction_minus );
+            if ( system.use_reservoir )
+                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::runge_dense_output<Type::complex>, "dense_output", grid_size, block_size, 0, current_halo, kernel_arguments, weights, ptrs.reservoir_minus, ptrs.buffer_reservoir_minus, ptrs.k_reservoir_minus );
+        }
+    }
+    dense_output_t = system.p.t;
+    system.p.t = t;
+    dense_output_active = true;
+}
+
+void PHOENIX::Solver::endDenseOutput() {
+    if ( not dense_output_active )
+        return;
+    const Type::uint32 current_halo = 0;
+    auto [block_size, grid_size] = getLaunchParameters( system.p.subgrid_N_c, system.p.subgrid_N_r );
+#pragma omp parallel for schedule( static )
+    for ( Type::uint32 subgrid = 0; subgrid < system.p.subgrids_columns * system.p.subgrids_rows; subgrid++ ) {
+        auto kernel_arguments = generateKernelArguments( subgrid );
+        auto& ptrs = kernel_arguments.dev_ptrs;
+        CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::copy_subgrid<Type::complex>, "dense_output_restore", grid_size, block_size, 0, current_halo, kernel_arguments, ptrs.wavefunction_plus, ptrs.buffer_wavefunction_plus );
+        if ( system.use_reservoir )
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::copy_subgrid<Type::complex>, "dense_output_restore", grid_size, block_size, 0, current_halo, kernel_arguments, ptrs.reservoir_plus, ptrs.buffer_reservoir_plus );
+        if ( system.use_twin_mode ) {
+            CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::copy_subgrid<Type::complex>, "dense_output_restore", grid_size, block_size, 0, current_halo, kernel_arguments, ptrs.wavefunction_minus, ptrs.buffer_wavefunction_minus );
+            if ( system.use_reservoir )
+                CALL_SUBGRID_KERNEL( PHOENIX::Kernel::Summation::copy_subgrid<Type::complex>, "dense_output_restore", grid_size, block_size, 0, current_halo, kernel_arguments, ptrs.reservoir_minus, ptrs.buffer_reservoir_minus );
+        }
+    }
+    system.p.t = dense_output_t;
+    dense_output_active = false;
+}
@@ -1,3 +1,4 @@
+#include <map>
 #include "cuda/typedef.cuh"
 #include "kernel/kernel_fft.cuh"
 #include "system/system_parameters.hpp"
@@ -7,6 +8,14 @@
 #ifdef USE_CPU
 
     #include <fftw3.h>
+    #include <tuple>
+    #ifdef USE_32_BIT_PRECISION
+        #define FFTW( name ) fftwf_##name
+    #else
+        #define FFTW( name ) fftw_##name
+    #endif
+using fft_type = FFTW( complex );
+using fft_plan = FFTW( plan );
 
 #else
 
@@ -27,23 +36,109 @@ using fft_type = cufftDoubleComplex;
 
 #ifdef USE_CUDA
 /**
- * Static Helper Function to get the cuFFT Plan. The static variables ensure the
- * fft plan is only created once. We don't destroy the plan and hope the operating
+ * Static Helper Function to get the cuFFT Plan. The static map ensures the
+ * fft plan is only created once per batch size. We don't destroy the plans and hope the operating
  * system will forgive us. We could also implement a small wrapper class that
  * holds the plan and calls the destruct method when the class instance is destroyed.
  */
-static cufftHandle& getFFTPlan( PHOENIX::Type::uint32 N_c, PHOENIX::Type::uint32 N_r ) {
-    static cufftHandle plan = 0;
-    static bool isInitialized = false;
+static cufftHandle& getFFTPlan( PHOENIX::Type::uint32 N_c, PHOENIX::Type::uint32 N_r, PHOENIX::Type::uint32 batch ) {
+    static std::map<PHOENIX::Type::uint32, cufftHandle> plans;
 
-    if ( not isInitialized ) {
-        if ( cufftPlan2d( &plan, N_c, N_r, FFTPLAN ) != CUFFT_SUCCESS ) {
+    if ( not plans.count( batch ) ) {
+        int n[2] = { int( N_c ), int( N_r ) };
+        const int dist = N_c * N_r;
+        if ( cufftPlanMany( &plans[batch], 2, n, nullptr, 1, dist, nullptr, 1, dist, FFTPLAN, batch ) != CUFFT_SUCCESS ) {
             std::cout << PHOENIX::CLIO::prettyPrint( "Error Creating CUDA FFT Plan!", PHOENIX::CLIO::Control::FullError ) << std::endl;
-            return plan;
         }
-        isInitialized = true;
     }
 
+    return plans[batch];
+}
+
+#else
+
+/**
+ * Translates the --fftPlanner string into the FFTW planner flags. Unknown
+ * strings fall back to FFTW_MEASURE.
+ */
+static unsigned int getFFTPlannerFlags( const std::string& planner ) {
+    if ( planner == "estimate" )
+        return FFTW_ESTIMATE;
+    if ( planner == "patient" )
+        return FFTW_PATIENT;
+    if ( planner == "exhaustive" )
+        return FFTW_EXHAUSTIVE;
+    if ( planner != "measure" )
+        std::cout << PHOENIX::CLIO::prettyPrint( "Unknown FFT planner '" + planner + "'. Falling back to 'measure'", PHOENIX::CLIO::Control::Warning ) << std::endl;
+    return FFTW_MEASURE;
+}
+
+/**
+ * Static Helper Function to get a cached FFTW Plan. Plans are keyed by size, batch count, direction,
+ * in-place or out-of-place and the alignment of the input and output arrays, such that
+ * a cached plan can be executed on any pair of arrays with fftw_execute_dft. Batches are stacked
+ * with a distance of N_c*N_r and transformed by a single fftw_plan_many_dft plan. Planning
+ * with FFTW_MEASURE or FFTW_PATIENT overwrites the arrays, so we plan on scratch arrays
+ * with the same alignment offset instead of the actual wavefunction. If a wisdom file
+ * is given, it is imported before the first plan is created and exported after every
+ * newly created plan. FFTW runs on system.fft_threads threads of the solver's OpenMP pool.
+ * Like the cuFFT plans, these plans are never destroyed.
+ */
+static fft_plan getFFTPlan( PHOENIX::SystemParameters& system, fft_type* in, fft_type* out, int direction, PHOENIX::Type::uint32 batch ) {
+    using key_type = std::tuple<PHOENIX::Type::uint32, PHOENIX::Type::uint32, PHOENIX::Type::uint32, int, bool, int, int>;
+    static std::map<key_type, fft_plan> plans;
+    static bool wisdom_loaded = false;
+    static bool threads_initialized = false;
+
+    const bool in_place = in == out;
+    const int alignment_in = FFTW( alignment_of )( reinterpret_cast<PHOENIX::Type::real*>( in ) );
+    const int alignment_out = in_place ? alignment_in : FFTW( alignment_of )( reinterpret_cast<PHOENIX::Type::real*>( out ) );
+    const key_type key{ system.p.N_c, system.p.N_r, batch, direction, in_place, alignment_in, alignment_out };
+
+    if ( auto it = plans.find( key ); it != plans.end() )
+        return it->second;
+
+    // Threaded FFTW has to be initialized before any other FFTW call, including the wisdom import.
+    if ( not threads_initialized ) {
+        threads_initialized = true;
+        if ( FFTW( init_threads )() )
+            FFTW( plan_with_nthreads )( system.fft_threads );
+        else
+            std::cout << PHOENIX::CLIO::prettyPrint( "Could not initialize threaded FFTW. Using a single FFT thread.", PHOENIX::CLIO::Control::Warning ) << std::endl;
+    }
+
+    if ( not wisdom_loaded and not system.fft_wisdom.empty() ) {
+        wisdom_loaded = true;
+        if ( FFTW( import_wisdom_from_filename )( system.fft_wisdom.c_str() ) )
+            std::cout << PHOENIX::CLIO::prettyPrint( "Loaded FFTW wisdom from '" + system.fft_wisdom + "'", PHOENIX::CLIO::Control::Info ) << std::endl;
+        else
+            std::cout << PHOENIX::CLIO::prettyPrint( "Could not load FFTW wisdom from '" + system.fft_wisdom + "'. Planning from scratch.", PHOENIX::CLIO::Control::Warning ) << std::endl;
+    }
+
+    // Scratch arrays with the same alignment offsets as the actual arrays. The extra padding covers the offset.
+    const int dist = system.p.N_c * system.p.N_r;
+    const size_t bytes = sizeof( fft_type ) * dist * batch;
+    char* scratch_in = reinterpret_cast<char*>( FFTW( malloc )( bytes + alignment_in ) );
+    char* scratch_out = in_place ? scratch_in : reinterpret_cast<char*>( FFTW( malloc )( bytes + alignment_out ) );
+    auto* plan_in = reinterpret_cast<fft_type*>( scratch_in + alignment_in );
+    auto* plan_out = in_place ? plan_in : reinterpret_cast<fft_type*>( scratch_out + alignment_out );
+
+    const int n[2] = { int( system.p.N_c ), int( system.p.N_r ) };
+    fft_plan plan = FFTW( plan_many_dft )( 2, n, batch, plan_in, nullptr, 1, dist, plan_out, nullptr, 1, dist, direction, getFFTPlannerFlags( system.fft_planner ) );
+
+    FFTW( free )( scratch_in );
+    if ( not in_place )
+        FFTW( free )( scratch_out );
+
+    if ( not plan ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "Error Creating FFTW Plan!", PHOENIX::CLIO::Control::FullError ) << std::endl;
+        return plan;
+    }
+    plans[key] = plan;
+
+    if ( not system.fft_wisdom.empty() )
+        FFTW( export_wisdom_to_filename )( system.fft_wisdom.c_str() );
+
     return plan;
 }
 
@@ -51,7 +146,7 @@ static cufftHandle& getFFTPlan( PHOENIX::Type::uint32 N_c, PHOENIX::Type::uint32
 
 /*
  * This function calculates the Fast Fourier Transformation of Psi+ and Psi-
- * and saves the result in dev_fft_plus and dev_fft_minus. These values can
+ * and saves the result in the stacked matrix.fft buffer. These values can
  * then be grabbed using the getDeviceArrays() function. The FFT is then
  * shifted such that k = 0 is in the center of the FFT matrix. Then, the
  * FFT Filter is applied to the FFT, and the FFT is shifted back. Finally,
@@ -66,54 +161,46 @@ static cufftHandle& getFFTPlan( PHOENIX::Type::uint32 N_c, PHOENIX::Type::uint32
 
 void PHOENIX::Solver::applyFFTFilter( bool apply_mask ) {
     auto [block_size, grid_size] = getLaunchParameters( system.p.N_c, system.p.N_r );
+    auto dev_ptrs = matrix.pointers( 0 );
+    // Both components are stacked in matrix.fft and transformed in a single batched FFT
+    const Type::uint32 batch = system.use_twin_mode ? 2 : 1;
 
-    matrix.wavefunction_plus.toFull( matrix.fft_plus );
-    // Calculate the actual FFTs
-    calculateFFT( GET_RAW_PTR( matrix.fft_plus ), GET_RAW_PTR( matrix.fft_plus ), FFT::forward );
-
-    // Do the FFT and the shifting here already for visualization only
-    if ( system.use_twin_mode ) {
-        matrix.wavefunction_minus.toFull( matrix.fft_minus );
-        calculateFFT( GET_RAW_PTR( matrix.fft_minus ), GET_RAW_PTR( matrix.fft_minus ), FFT::forward );
-    }
+    matrix.wavefunction_plus.toFull( dev_ptrs.fft_plus );
+    if ( system.use_twin_mode )
+        matrix.wavefunction_minus.toFull( dev_ptrs.fft_minus );
+    // Calculate the actual FFTs. Do the FFT here already for visualization only
+    calculateFFT( dev_ptrs.fft_plus, dev_ptrs.fft_plus, FFT::forward, batch );
 
     if ( not apply_mask )
         return;
 
     // Apply the FFT Mask Filter
     CALL_FULL_KERNEL( PHOENIX::Kernel::kernel_mask_fft<fft_template_type>, "FFT Mask Plus", grid_size, block_size, 0, // 0 = default stream
-                      GET_RAW_PTR( matrix.fft_plus ), GET_RAW_PTR( matrix.fft_mask_plus ), system.p.N_c * system.p.N_r );
+                      dev_ptrs.fft_plus, dev_ptrs.fft_mask_plus, system.p.N_c * system.p.N_r );
 
     if ( system.use_twin_mode ) {
         CALL_FULL_KERNEL( PHOENIX::Kernel::kernel_mask_fft<fft_template_type>, "FFT Mask Minus", grid_size, block_size, 0, // 0 = default stream
-                          GET_RAW_PTR( matrix.fft_minus ), GET_RAW_PTR( matrix.fft_mask_minus ), system.p.N_c * system.p.N_r );
+                          dev_ptrs.fft_minus, dev_ptrs.fft_mask_minus, system.p.N_c * system.p.N_r );
     }
 
-    // Transform back.
-    calculateFFT( GET_RAW_PTR( matrix.fft_plus ), matrix.wavefunction_plus.fullMatrixPointer(), FFT::inverse );
-    matrix.wavefunction_plus.toSubgrids();
-
-    if ( system.use_twin_mode ) {
-        calculateFFT( GET_RAW_PTR( matrix.fft_minus ), matrix.wavefunction_minus.fullMatrixPointer(), FFT::inverse );
-        matrix.wavefunction_minus.toSubgrids();
-    }
+    // Transform back into the stacked buffer and scatter the components to their subgrids.
+    calculateFFT( dev_ptrs.fft_plus, dev_ptrs.buffer_fft_plus, FFT::inverse, batch );
+    matrix.wavefunction_plus.toSubgrids( dev_ptrs.buffer_fft_plus );
+    if ( system.use_twin_mode )
+        matrix.wavefunction_minus.toSubgrids( dev_ptrs.buffer_fft_minus );
+    // The halo left from the last exchange does not hold the filtered wavefunction, see --haloDepth
+    halo_consumed = 0;
 }
 
-void PHOENIX::Solver::calculateFFT( Type::complex* device_ptr_in, Type::complex* device_ptr_out, FFT dir ) {
+void PHOENIX::Solver::calculateFFT( Type::complex* device_ptr_in, Type::complex* device_ptr_out, FFT dir, Type::uint32 batch ) {
 #ifdef USE_CUDA
     // Do FFT using CUDAs FFT functions
-    auto plan = getFFTPlan( system.p.N_c, system.p.N_r );
+    auto plan = getFFTPlan( system.p.N_c, system.p.N_r, batch );
     CHECK_CUDA_ERROR( FFTSOLVER( plan, reinterpret_cast<fft_type*>( device_ptr_in ), reinterpret_cast<fft_type*>( device_ptr_out ), dir == FFT::inverse ? CUFFT_INVERSE : CUFFT_FORWARD ), "FFT Exec" );
 #else
-    // auto [plan_forward, plan_inverse] = getFFTPlan(system.p.N_c, system.p.N_r, device_ptr_in, device_ptr_out);
-    #ifdef USE_32_BIT_PRECISION
-    auto plan = fftwf_plan_dft_2d( system.p.N_c, system.p.N_r, reinterpret_cast<fftwf_complex*>( device_ptr_in ), reinterpret_cast<fftwf_complex*>( device_ptr_out ), dir == FFT::inverse ? FFTW_BACKWARD : FFTW_FORWARD, FFTW_ESTIMATE );
-    fftwf_execute( plan );
-    fftwf_destroy_plan( plan );
-    #else
-    auto plan = fftw_plan_dft_2d( system.p.N_c, system.p.N_r, reinterpret_cast<fftw_complex*>( device_ptr_in ), reinterpret_cast<fftw_complex*>( device_ptr_out ), dir == FFT::inverse ? FFTW_BACKWARD : FFTW_FORWARD, FFTW_ESTIMATE );
-    fftw_execute( plan );
-    fftw_destroy_plan( plan );
-    #endif
+    auto* in = reinterpret_cast<fft_type*>( device_ptr_in );
+    auto* out = reinterpret_cast<fft_type*>( device_ptr_out );
+    auto plan = getFFTPlan( system, in, out, dir == FFT::inverse ? FFTW_BACKWARD : FFTW_FORWARD, batch );
+    FFTW( execute_dft )( plan, in, out );
 #endif
 }
\ No newline at end of file
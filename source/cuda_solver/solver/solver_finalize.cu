@@ -3,6 +3,8 @@
 #include "misc/commandline_io.hpp"
 
 void PHOENIX::Solver::finalize() {
+    completeSplitStep();
+    completeReservoirCycle();
     // Output Matrices
     outputMatrices( 0 /*start*/, system.p.N_c /*end*/, 0 /*start*/, system.p.N_r /*end*/, 1.0 /*increment*/ );
     // Cache to files
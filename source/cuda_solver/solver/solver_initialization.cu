@@ -15,7 +15,7 @@ void PHOENIX::Solver::initializeMatricesFromSystem() {
               << EscapeSequence::RESET << std::endl;
 
     // First, construct all required host matrices
-    bool use_fft = system.fft_every < system.t_max or system.iterator == "ssfm";
+    bool use_fft = system.fft_every < system.t_max or system.iterator == "ssfm" or system.iterator == "ssfm4" or system.iterator == "ifrk4" or system.use_spectral_laplacian;
     // For now, both the plus and the minus components are the same. TODO: Change
     Type::uint32 pulse_size = system.pulse.groupSize();
     Type::uint32 pump_size = system.pump.groupSize();
@@ -158,12 +158,14 @@ T delta( T a, T b ) {
 void PHOENIX::Solver::initializeHaloMap() {
     std::cout << PHOENIX::CLIO::prettyPrint( "Initializing Halo Map...", PHOENIX::CLIO::Control::Info ) << std::endl;
 
-    PHOENIX::Type::host_vector<int> halo_map;
+    PHOENIX::Type::host_vector<Kernel::Halo::HaloRectangle> halo_rectangles;
+    Type::uint32 halo_rows = 0;
+    Type::uint32 halo_cells = 0;
 
-    // Create subgrid map
+    // One rectangle per neighbour. Without a halo, there is nothing to synchronize.
     for ( int dr = -1; dr <= 1; dr++ ) {
         for ( int dc = -1; dc <= 1; dc++ ) {
-            if ( dc == 0 and dr == 0 )
+            if ( ( dc == 0 and dr == 0 ) or system.p.halo_size == 0 )
                 continue;
 
             const Type::uint32 fr0 = delta( -1, dr ) * system.p.subgrid_N_r + ( 1 - delta( -1, dr ) ) * system.p.halo_size;
@@ -176,22 +178,20 @@ void PHOENIX::Solver::initializeHaloMap() {
             const Type::uint32 tc0 = delta( 1, dc ) * system.p.subgrid_N_c + ( 1 - delta( -1, dc ) ) * system.p.halo_size;
             const Type::uint32 tc1 = ( 1 - delta( -1, dc ) ) * system.p.subgrid_N_c + system.p.halo_size + delta( 1, dc ) * system.p.halo_size;
 
-            for ( int i = 0; i < fr1 - fr0; i++ ) {
-                for ( int j = 0; j < fc1 - fc0; j++ ) {
-                    const int from_row = fr0 + i;
-                    const int from_col = fc0 + j;
-                    const int to_row = tr0 + i;
-                    const int to_col = tc0 + j;
-                    halo_map.push_back( dr );
-                    halo_map.push_back( dc );
-                    halo_map.push_back( from_row );
-                    halo_map.push_back( from_col );
-                    halo_map.push_back( to_row );
-                    halo_map.push_back( to_col );
-                }
-            }
+            Kernel::Halo::HaloRectangle rectangle;
+            rectangle.dr = dr;
+            rectangle.dc = dc;
+            rectangle.from = fr0 * system.p.subgrid_row_offset + fc0;
+            rectangle.to = tr0 * system.p.subgrid_row_offset + tc0;
+            rectangle.rows = fr1 - fr0;
+            rectangle.cols = fc1 - fc0;
+            rectangle.first_row = halo_rows;
+            halo_rectangles.push_back( rectangle );
+            halo_rows += rectangle.rows;
+            halo_cells += rectangle.rows * rectangle.cols;
         }
     }
-    std::cout << PHOENIX::CLIO::prettyPrint( "Designated number of halo cells: " + std::to_string( halo_map.size() / 6 ), PHOENIX::CLIO::Control::Secondary | PHOENIX::CLIO::Control::Success ) << std::endl;
-    matrix.halo_map = halo_map;
+    std::cout << PHOENIX::CLIO::prettyPrint( "Designated number of halo cells: " + std::to_string( halo_cells ) + " in " + std::to_string( halo_rows ) + " rows", PHOENIX::CLIO::Control::Secondary | PHOENIX::CLIO::Control::Success ) << std::endl;
+    matrix.halo_rectangles = halo_rectangles;
+    matrix.halo_rows = halo_rows;
 }
\ No newline at end of file
@@ -37,7 +37,7 @@ void PHOENIX::Solver::outputMatrices( const Type::uint32 start_x, const Type::ui
             //filehandler.outputMatrixToFile( buffer.data(), start_x, end_x, start_y, end_y, system.p.N_c, system.p.N_r, increment, header_information, prefix + key + suffix );
         }
         if ( system.fft_every < system.t_max and key == "fft_plus" and system.doOutput( "fft_mask", "fft", "fft_plus", "plus", "mat", "all" ) ) {
-            Type::host_vector<Type::complex> buffer = matrix.fft_plus;
+            Type::host_vector<Type::complex> buffer( matrix.fft.begin(), matrix.fft.begin() + system.p.N_c * system.p.N_r );
             auto future = std::async( std::launch::async, [buffer, fft_header_information, start_x, end_x, start_y, end_y, increment, this, key, suffix, prefix]() { this->system.filehandler.outputMatrixToFile( buffer.data(), start_x, end_x, start_y, end_y, this->system.p.N_c, this->system.p.N_r, increment, fft_header_information, prefix + key + suffix ); } );
             //filehandler.outputMatrixToFile( buffer.data(), start_x, end_x, start_y, end_y, system.p.N_c, system.p.N_r, increment, fft_header_information, prefix + key + suffix );
         }
@@ -55,7 +55,7 @@ void PHOENIX::Solver::outputMatrices( const Type::uint32 start_x, const Type::ui
             //filehandler.outputMatrixToFile( buffer.data(), start_x, end_x, start_y, end_y, system.p.N_c, system.p.N_r, increment, header_information, prefix + key + suffix );
         }
         if ( system.fft_every < system.t_max and key == "fft_minus" and system.doOutput( "fft_mask", "fft", "fft_minus", "plus", "mat", "all" ) ) {
-            Type::host_vector<Type::complex> buffer = matrix.fft_minus;
+            Type::host_vector<Type::complex> buffer( matrix.fft.begin() + system.p.N_c * system.p.N_r, matrix.fft.end() );
             auto future = std::async( std::launch::async, [buffer, fft_header_information, start_x, end_x, start_y, end_y, increment, this, key, suffix, prefix]() { this->system.filehandler.outputMatrixToFile( buffer.data(), start_x, end_x, start_y, end_y, this->system.p.N_c, this->system.p.N_r, increment, fft_header_information, prefix + key + suffix ); } );
             //filehandler.outputMatrixToFile( buffer.data(), start_x, end_x, start_y, end_y, system.p.N_c, system.p.N_r, increment, fft_header_information, prefix + key + suffix );
         }
@@ -74,10 +74,12 @@ void PHOENIX::Solver::outputInitialMatrices() {
 
         auto future = std::async( std::launch::async, [buffer1, buffer2, header_information, this]() {
             this->system.filehandler.outputMatrixToFile( buffer1.data(), this->system.p.N_c, this->system.p.N_r, header_information, "initial_wavefunction_plus" );
-            this->system.filehandler.outputMatrixToFile( buffer2.data(), this->system.p.N_c, this->system.p.N_r, header_information, "initial_reservoir_plus" );
+            // The initial reservoir is only constructed if the reservoir is used
+            if ( not buffer2.empty() )
+                this->system.filehandler.outputMatrixToFile( buffer2.data(), this->system.p.N_c, this->system.p.N_r, header_information, "initial_reservoir_plus" );
         } );
     }
-    if ( system.use_reservoir and system.doOutput( "all", "mat", "pump_plus", "pump" ) )
+    if ( system.use_pumps and system.doOutput( "all", "mat", "pump_plus", "pump" ) )
         for ( int i = 0; i < system.pump.groupSize(); i++ ) {
             auto osc_header_information = PHOENIX::FileHandler::Header( system.p.L_x, system.p.L_y, system.p.dx, system.p.dy, system.p.t, system.pump.t0[i], system.pump.freq[i], system.pump.sigma[i] );
             std::string suffix = i > 0 ? "_" + std::to_string( i ) : "";
@@ -120,10 +122,12 @@ void PHOENIX::Solver::outputInitialMatrices() {
         //system.filehandler.outputMatrixToFile( matrix.initial_reservoir_minus.data(), system.p.N_c, system.p.N_r, header_information, "initial_reservoir_minus" );
         auto future = std::async( std::launch::async, [buffer1, buffer2, header_information, this]() {
             this->system.filehandler.outputMatrixToFile( buffer1.data(), this->system.p.N_c, this->system.p.N_r, header_information, "initial_wavefunction_minus" );
-            this->system.filehandler.outputMatrixToFile( buffer2.data(), this->system.p.N_c, this->system.p.N_r, header_information, "initial_reservoir_minus" );
+            // The initial reservoir is only constructed if the reservoir is used
+            if ( not buffer2.empty() )
+                this->system.filehandler.outputMatrixToFile( buffer2.data(), this->system.p.N_c, this->system.p.N_r, header_information, "initial_reservoir_minus" );
         } );
     }
-    if ( system.use_reservoir and system.doOutput( "all", "mat", "pump_minus", "pump" ) )
+    if ( system.use_pumps and system.doOutput( "all", "mat", "pump_minus", "pump" ) )
         for ( int i = 0; i < system.pump.groupSize(); i++ ) {
             auto osc_header_information = PHOENIX::FileHandler::Header( system.p.L_x, system.p.L_y, system.p.dx, system.p.dy, system.p.t, system.pump.t0[i], system.pump.freq[i], system.pump.sigma[i] );
             std::string suffix = i > 0 ? "_" + std::to_string( i ) : "";
@@ -0,0 +1,156 @@
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "cuda/typedef.cuh"
+#include "solver/gpu_solver.hpp"
+#include "misc/commandline_io.hpp"
+
+/*
+ * Parareal integrates a window of time slices at once. Every slice spans one output interval.
+ * A cheap coarse propagator G predicts the states at the slice ends serially. The fine propagator F,
+ * i.e. the fixed timestep RK iterator of the system, then advances every slice from its predicted
+ * start concurrently, and the serial correction
+ *      U_k+1 = G( U_k ) + F( U_k^old ) - G( U_k^old )
+ * propagates the fine results through the window. After iteration j, the first j slices are exact, so
+ * the iteration ends with the fine solution after at most one iteration per slice, but usually stops
+ * much earlier, once the relative change of the slice ends is below --parareal's tolerance.
+ * The fine propagators are solvers of their own, which share the system but own their matrices. They
+ * are advanced by propagate, which does not touch the system time, on their own share of the threads.
+ */
+
+void PHOENIX::Solver::getState( Type::device_vector<Type::complex>& state ) {
+    const Type::uint32 components = ( system.use_reservoir ? 2 : 1 ) * ( system.use_twin_mode ? 2 : 1 );
+    if ( state.size() != components * system.p.N2 )
+        state = Type::device_vector<Type::complex>( components * system.p.N2 );
+    Type::complex* ptr = GET_RAW_PTR( state );
+    matrix.wavefunction_plus.toFull( ptr );
+    if ( system.use_reservoir )
+        matrix.reservoir_plus.toFull( ptr += system.p.N2 );
+    if ( system.use_twin_mode ) {
+        matrix.wavefunction_minus.toFull( ptr += system.p.N2 );
+        if ( system.use_reservoir )
+            matrix.reservoir_minus.toFull( ptr += system.p.N2 );
+    }
+}
+
+// The halos are synchronized as well, such that they do not keep values of the previous state
+void PHOENIX::Solver::setState( Type::device_vector<Type::complex>& state ) {
+    Type::complex* ptr = GET_RAW_PTR( state );
+    matrix.wavefunction_plus.toSubgrids( ptr );
+    SYNCHRONIZE_HALOS( 0, matrix.wavefunction_plus.getSubgridDevicePtrs() );
+    if ( system.use_reservoir ) {
+        matrix.reservoir_plus.toSubgrids( ptr += system.p.N2 );
+        SYNCHRONIZE_HALOS( 0, matrix.reservoir_plus.getSubgridDevicePtrs() );
+    }
+    if ( system.use_twin_mode ) {
+        matrix.wavefunction_minus.toSubgrids( ptr += system.p.N2 );
+        SYNCHRONIZE_HALOS( 0, matrix.wavefunction_minus.getSubgridDevicePtrs() );
+        if ( system.use_reservoir ) {
+            matrix.reservoir_minus.toSubgrids( ptr += system.p.N2 );
+            SYNCHRONIZE_HALOS( 0, matrix.reservoir_minus.getSubgridDevicePtrs() );
+        }
+    }
+    halo_consumed = 0;
+}
+
+PHOENIX::Type::uint32 PHOENIX::Solver::propagate( const std::string& name, const Type::real t, const Type::real t_end, const Type::real dt ) {
+    if ( t_end <= t )
+        return 0;
+    // Equal steps, such that the slice ends exactly at t_end
+    const Type::uint32 steps = std::max<Type::uint32>( 1, Type::uint32( std::ceil( ( t_end - t ) / dt - 1E-6 ) ) );
+    const Type::real step = ( t_end - t ) / steps;
+    for ( Type::uint32 n = 0; n < steps; n++ ) {
+        updateKernelArguments( t + n * step, step );
+        iterator.at( name ).iterate();
+    }
+    return steps;
+}
+
+void PHOENIX::Solver::iterateParareal( const std::function<void()>& output ) {
+    // The slices end at the output times
+    std::vector<Type::real> slice_t = { system.p.t };
+    const Type::real first_output = std::round( system.p.t / system.output_every );
+    while ( slice_t.size() <= system.parareal_slices and slice_t.back() < system.t_max ) slice_t.push_back( std::min<Type::real>( ( first_output + slice_t.size() ) * system.output_every, system.t_max ) );
+    const Type::uint32 slices = slice_t.size() - 1;
+    if ( slices == 0 )
+        return;
+
+    if ( parareal_propagators.empty() ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "Creating " + std::to_string( system.parareal_slices ) + " fine parareal propagators", PHOENIX::CLIO::Control::Info ) << std::endl;
+        for ( Type::uint32 k = 0; k < system.parareal_slices; k++ ) parareal_propagators.push_back( std::make_unique<Solver>( system, true ) );
+    }
+
+    // Slice states, and the coarse and fine solutions of every slice
+    std::vector<Type::device_vector<Type::complex>> state( slices + 1 ), coarse( slices ), fine( slices );
+    Type::device_vector<Type::complex> buffer;
+    getState( state[0] );
+    for ( Type::uint32 k = 0; k < slices; k++ ) {
+        propagate( system.parareal_coarse_iterator, slice_t[k], slice_t[k + 1], system.parareal_coarse_dt );
+        getState( coarse[k] );
+        state[k + 1] = coarse[k];
+    }
+
+    // Nested parallelism: the slices are distributed over the workers, which split the threads among themselves
+    const int max_active_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels( 2 );
+    Type::uint32 fine_steps = 0;
+    Type::uint32 non_finite = 0;
+    parareal_iterations = 0;
+    // The slices before the first open one are exact
+    for ( Type::uint32 first_open = 0; first_open < slices; first_open++ ) {
+        parareal_iterations++;
+        const Type::uint32 workers = std::min( slices - first_open, system.omp_max_threads );
+        const Type::uint32 threads = std::max<Type::uint32>( 1, system.omp_max_threads / workers );
+#pragma omp parallel for schedule( dynamic, 1 ) num_threads( workers ) reduction( + : fine_steps )
+        for ( Type::uint32 k = first_open; k < slices; k++ ) {
+            omp_set_num_threads( threads );
+            auto& propagator = *parareal_propagators[k];
+            propagator.setState( state[k] );
+            fine_steps += propagator.propagate( system.iterator, slice_t[k], slice_t[k + 1], system.p.dt );
+            propagator.getState( fine[k] );
+        }
+
+        // The first open slice started from an exact state
+        state[first_open + 1] = fine[first_open];
+        Type::real change = 0.0;
+        Type::real magnitude = 0.0;
+        // A diverged coarse propagator corrupts the open slices. These then become exact one by one, as if the slices were integrated serially.
+        for ( Type::uint32 k = first_open + 1; k < slices; k++ ) {
+            setState( state[k] );
+            propagate( system.parareal_coarse_iterator, slice_t[k], slice_t[k + 1], system.parareal_coarse_dt );
+            getState( buffer );
+            Type::complex* PHOENIX_RESTRICT u = GET_RAW_PTR( state[k + 1] );
+            const Type::complex* PHOENIX_RESTRICT g = GET_RAW_PTR( buffer );
+            const Type::complex* PHOENIX_RESTRICT f = GET_RAW_PTR( fine[k] );
+            const Type::complex* PHOENIX_RESTRICT g_old = GET_RAW_PTR( coarse[k] );
+            const Type::uint32 size = buffer.size();
+#pragma omp parallel for schedule( static ) reduction( max : change, magnitude ) reduction( + : non_finite )
+            for ( Type::uint32 i = 0; i < size; i++ ) {
+                const Type::complex corrected = g[i] + f[i] - g_old[i];
+                if ( not std::isfinite( CUDA::abs( corrected ) ) )
+                    non_finite++;
+                change = std::max( change, CUDA::abs( corrected - u[i] ) );
+                magnitude = std::max( magnitude, CUDA::abs( corrected ) );
+                u[i] = corrected;
+            }
+            std::swap( coarse[k], buffer );
+        }
+        if ( non_finite == 0 and change <= system.parareal_tolerance * magnitude )
+            break;
+    }
+    if ( non_finite > 0 )
+        std::cout << PHOENIX::CLIO::prettyPrint( "The coarse parareal propagator diverged, consider reducing its dt", PHOENIX::CLIO::Control::Warning ) << std::endl;
+    omp_set_max_active_levels( max_active_levels );
+    system.iteration += fine_steps;
+
+    for ( Type::uint32 k = 1; k <= slices; k++ ) {
+        setState( state[k] );
+        system.p.t = slice_t[k];
+        updateKernelArguments( system.p.t, system.p.dt );
+        if ( system.fft_every < system.t_max )
+            applyFFTFilter( false );
+        output();
+    }
+}
@@ -0,0 +1,176 @@
+#include <cmath>
+#include <limits>
+#include <functional>
+#include <map>
+#include <vector>
+#include "cuda/typedef.cuh"
+#include "solver/gpu_solver.hpp"
+#include "solver/runge_kutta_tableau.hpp"
+#include "misc/commandline_io.hpp"
+
+using StabilityFunction = std::function<PHOENIX::Type::complex( PHOENIX::Type::complex )>;
+
+/**
+ * Largest dt for which |R(lambda dt')| <= 1 holds for all dt' <= dt. The ray lambda dt is scanned
+ * in small steps of 1/|lambda| up to the exit from the stability region, which is then refined by
+ * bisection. Returns zero if the ray leaves the region immediately, e.g. for the explicit Euler
+ * method and an undamped eigenvalue on the imaginary axis.
+ */
+static PHOENIX::Type::real stabilityLimit( const StabilityFunction& R, const PHOENIX::Type::complex lambda ) {
+    using namespace PHOENIX;
+    const Type::real magnitude = CUDA::abs( lambda );
+    if ( magnitude == 0.0 )
+        return std::numeric_limits<Type::real>::infinity();
+    const Type::complex direction = lambda / magnitude;
+    const auto stable = [&]( Type::real x ) { return CUDA::abs( R( x * direction ) ) <= Type::real( 1.0 + 1E-10 ); };
+
+    // No explicit scheme we use is stable beyond |z| = 10
+    const Type::real step = 1E-3;
+    Type::real lower = 0.0;
+    while ( lower < 10.0 and stable( lower + step ) ) lower += step;
+    Type::real upper = lower + step;
+    for ( int i = 0; i < 30; i++ ) {
+        const Type::real middle = 0.5 * ( lower + upper );
+        if ( stable( middle ) )
+            lower = middle;
+        else
+            upper = middle;
+    }
+    return lower / magnitude;
+}
+
+/**
+ * Largest stable dt of the current iterator for the given bounds of |Psi|^2, the reservoir and the potential.
+ * The wavefunction is modelled by the eigenvalue -gamma_c/2 - i omega, where omega is the largest frequency of the
+ * discrete kinetic term, given by the spectral radius of the Laplacian, plus the largest local frequency of the
+ * interaction, reservoir coupling and potential. The reservoir is modelled by its decay rate -(gamma_r + R |Psi|^2).
+ * The gain R n/2 of the wavefunction is a physical growth and not considered. For each eigenvalue, the limit follows
+ * from the stability function of the scheme, see RungeKutta::stabilityFunction.
+ * The kinetic term is integrated exactly by the split step and integrating factor iterators, and the nonlinear
+ * step of the split step iterators is an exact exponential. Their reservoir is advanced with the explicit Euler
+ * method. If no part is limited, infinity is returned.
+ */
+PHOENIX::Type::real PHOENIX::Solver::stableTimestep( const Type::real psi_max, const Type::real reservoir_max, const Type::real potential_max ) {
+    const StabilityFunction euler = []( Type::complex z ) { return Type::real( 1.0 ) + z; };
+    // Dormand-Prince 5(4), propagated with the 5th order solution
+    const StabilityFunction dormand_prince = []( Type::complex z ) { return Type::real( 1.0 ) + z * ( Type::real( 1.0 ) + z * ( Type::real( 1.0 / 2.0 ) + z * ( Type::real( 1.0 / 6.0 ) + z * ( Type::real( 1.0 / 24.0 ) + z * ( Type::real( 1.0 / 120.0 ) + z * Type::real( 1.0 / 600.0 ) ) ) ) ) ); };
+    const std::map<std::string, StabilityFunction> stability_function = { { "newton", euler }, { "ralston", RungeKutta::stabilityFunction<RungeKutta::Ralston> }, { "rk3", RungeKutta::stabilityFunction<RungeKutta::RK3> }, { "ssprk3", RungeKutta::stabilityFunction<RungeKutta::SSPRK3> }, { "rk4", RungeKutta::stabilityFunction<RungeKutta::RK4> }, { "lsrk4", RungeKutta::stabilityFunction<RungeKutta::LowStorageRK4> }, { "rk45", dormand_prince }, { "ifrk4", RungeKutta::stabilityFunction<RungeKutta::RK4> } };
+
+    const bool split_step = system.iterator == "ssfm" or system.iterator == "ssfm4" or system.iterator == "adi";
+    const bool exact_kinetic = split_step or system.iterator == "ifrk4";
+    const StabilityFunction& scheme = split_step ? euler : stability_function.at( system.iterator );
+
+    // Spectral radius of the discrete Laplacian per 1/dx^2, see --stencil
+    Type::real laplacian_radius = 4.0;
+    if ( system.p.stencil_radius == 0 )
+        laplacian_radius = 3.1415926535 * 3.1415926535;
+    else if ( system.p.stencil_radius == 2 )
+        laplacian_radius = 16.0 / 3.0;
+    else if ( system.p.stencil_radius == 3 )
+        laplacian_radius = 272.0 / 45.0;
+    const Type::real kinetic = exact_kinetic ? 0.0 : ( std::abs( system.p.m_eff_scaled ) + std::abs( system.p.delta_LT ) ) * laplacian_radius * ( system.p.one_over_dx2 + system.p.one_over_dy2 );
+    const Type::real local = std::abs( system.p.g_c ) * psi_max + std::abs( system.p.g_r ) * reservoir_max + potential_max;
+
+    Type::real stable_dt = std::numeric_limits<Type::real>::infinity();
+    // The nonlinear step of the split step iterators is an exact exponential
+    if ( not split_step ) {
+        const Type::complex lambda = Type::complex( -0.5 * system.p.gamma_c, -( kinetic + local ) * system.p.one_over_h_bar_s );
+        stable_dt = std::min( stable_dt, stabilityLimit( scheme, lambda ) );
+    }
+    if ( system.use_reservoir ) {
+        const Type::complex lambda = -( system.p.gamma_r + system.p.R * psi_max );
+        stable_dt = std::min( stable_dt, stabilityLimit( scheme, lambda ) );
+    }
+    return stable_dt;
+}
+
+// The envelopes are bounded by their largest temporal amplitude
+static PHOENIX::Type::real envelopeMax( PHOENIX::Envelope& envelope, const PHOENIX::Type::real t ) {
+    envelope.updateTemporal( t );
+    PHOENIX::Type::real result = 0.0;
+    for ( const auto& amp : envelope.temporal_envelope ) result = std::max( result, PHOENIX::CUDA::abs( PHOENIX::Type::complex( amp ) ) );
+    return result;
+}
+
+/**
+ * Estimates the largest stable dt of the current iterator for the current state, using the maxima of
+ * |Psi|^2, the reservoir (or the pump for the adiabatic reservoir) and the potential, see stableTimestep.
+ */
+PHOENIX::Type::real PHOENIX::Solver::estimateStableTimestep() {
+    Type::real psi_max = matrix.wavefunction_plus.transformMax( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::abs2( a ); } );
+    if ( system.use_twin_mode )
+        psi_max = std::max( psi_max, matrix.wavefunction_minus.transformMax( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::abs2( a ); } ) );
+    Type::real reservoir_max = 0.0;
+    if ( system.use_reservoir ) {
+        reservoir_max = matrix.reservoir_plus.transformMax( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::abs( a ); } );
+        if ( system.use_twin_mode )
+            reservoir_max = std::max( reservoir_max, matrix.reservoir_minus.transformMax( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::abs( a ); } ) );
+    }
+    if ( system.use_adiabatic_reservoir ) {
+        Type::real pump_max = matrix.pump_plus.transformMax( [] PHOENIX_HOST_DEVICE( Type::real a ) { return a < 0.0 ? -a : a; } );
+        if ( system.use_twin_mode )
+            pump_max = std::max( pump_max, matrix.pump_minus.transformMax( [] PHOENIX_HOST_DEVICE( Type::real a ) { return a < 0.0 ? -a : a; } ) );
+        reservoir_max = pump_max * envelopeMax( system.pump, system.p.t ) / system.p.gamma_r;
+    }
+    Type::real potential_max = 0.0;
+    if ( system.use_potentials ) {
+        potential_max = matrix.potential_plus.transformMax( [] PHOENIX_HOST_DEVICE( Type::real a ) { return a < 0.0 ? -a : a; } );
+        if ( system.use_twin_mode )
+            potential_max = std::max( potential_max, matrix.potential_minus.transformMax( [] PHOENIX_HOST_DEVICE( Type::real a ) { return a < 0.0 ? -a : a; } ) );
+        potential_max *= envelopeMax( system.potential, system.p.t );
+    }
+    return stableTimestep( psi_max, reservoir_max, potential_max );
+}
+
+// Elementwise maximum of two per subgrid reductions
+static void maxInto( std::vector<PHOENIX::Type::real>& result, const std::vector<PHOENIX::Type::real>& other ) {
+    for ( size_t i = 0; i < result.size(); i++ ) result[i] = std::max( result[i], other[i] );
+}
+
+/**
+ * Same as estimateStableTimestep, but for every subgrid from the maxima within the subgrid and its halo.
+ * Used to assign the local time step levels, see --localTimestep.
+ */
+std::vector<PHOENIX::Type::real> PHOENIX::Solver::estimateStableTimestepPerSubgrid() {
+    const Type::uint32 subgrids = system.p.subgrids_columns * system.p.subgrids_rows;
+    auto psi_max = matrix.wavefunction_plus.transformMaxPerSubgrid( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::abs2( a ); } );
+    if ( system.use_twin_mode )
+        maxInto( psi_max, matrix.wavefunction_minus.transformMaxPerSubgrid( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::abs2( a ); } ) );
+    std::vector<Type::real> reservoir_max( subgrids, 0.0 );
+    if ( system.use_reservoir ) {
+        reservoir_max = matrix.reservoir_plus.transformMaxPerSubgrid( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::abs( a ); } );
+        if ( system.use_twin_mode )
+            maxInto( reservoir_max, matrix.reservoir_minus.transformMaxPerSubgrid( [] PHOENIX_HOST_DEVICE( Type::complex a ) { return CUDA::abs( a ); } ) );
+    }
+    if ( system.use_adiabatic_reservoir ) {
+        reservoir_max = matrix.pump_plus.transformMaxPerSubgrid( [] PHOENIX_HOST_DEVICE( Type::real a ) { return a < 0.0 ? -a : a; } );
+        if ( system.use_twin_mode )
+            maxInto( reservoir_max, matrix.pump_minus.transformMaxPerSubgrid( [] PHOENIX_HOST_DEVICE( Type::real a ) { return a < 0.0 ? -a : a; } ) );
+        const Type::real scale = envelopeMax( system.pump, system.p.t ) / system.p.gamma_r;
+        for ( auto& value : reservoir_max ) value *= scale;
+    }
+    std::vector<Type::real> potential_max( subgrids, 0.0 );
+    if ( system.use_potentials ) {
+        potential_max = matrix.potential_plus.transformMaxPerSubgrid( [] PHOENIX_HOST_DEVICE( Type::real a ) { return a < 0.0 ? -a : a; } );
+        if ( system.use_twin_mode )
+            maxInto( potential_max, matrix.potential_minus.transformMaxPerSubgrid( [] PHOENIX_HOST_DEVICE( Type::real a ) { return a < 0.0 ? -a : a; } ) );
+        const Type::real envelope = envelopeMax( system.potential, system.p.t );
+        for ( auto& value : potential_max ) value *= envelope;
+    }
+    std::vector<Type::real> stable_dt( subgrids );
+    for ( Type::uint32 subgrid = 0; subgrid < subgrids; subgrid++ ) stable_dt[subgrid] = stableTimestep( psi_max[subgrid], reservoir_max[subgrid], potential_max[subgrid] );
+    return stable_dt;
+}
+
+void PHOENIX::Solver::reportStableTimestep() {
+    const Type::real stable_dt = estimateStableTimestep();
+    if ( not std::isfinite( stable_dt ) ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "The timestep of iterator '" + system.iterator + "' is not limited by stability", PHOENIX::CLIO::Control::Info ) << std::endl;
+        return;
+    }
+    std::cout << PHOENIX::CLIO::prettyPrint( "Estimated stable timestep for iterator '" + system.iterator + "': " + PHOENIX::CLIO::to_str( stable_dt ) + " ps", PHOENIX::CLIO::Control::Info ) << std::endl;
+    // With local time stepping, the fastest subgrids subcycle dt down to dt / 2^levels
+    const Type::real finest_dt = system.p.dt / Type::real( 1u << system.local_timestep_levels );
+    if ( finest_dt > stable_dt )
+        std::cout << PHOENIX::CLIO::prettyPrint( "dt = " + PHOENIX::CLIO::to_str( finest_dt ) + " ps exceeds the estimated stability limit of the initial state!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+}
@@ -59,6 +59,17 @@ int main( int argc, char* argv[] ) {
     double complete_duration = 0.;
     PHOENIX::Type::uint32 out_every_iterations = 1;
     PHOENIX::Type::real dt = system.p.dt;
+    // Adapt dt to the stability limit of the current state, see --autoTimestep
+    const auto adapt_timestep = [&]() {
+        if ( system.auto_timestep <= 0.0 )
+            return;
+        const PHOENIX::Type::real stable_dt = solver.estimateStableTimestep();
+        if ( std::isfinite( stable_dt ) and stable_dt > 0.0 )
+            dt = system.p.dt = system.auto_timestep * stable_dt;
+    };
+    adapt_timestep();
+    // Interpolate the output from the last step instead of shrinking dt to the output times, see beginDenseOutput
+    const bool dense_output = system.disableRender and solver.supportsDenseOutput();
     // Main Loop
 #ifdef BENCH
     #ifdef LIKWID
@@ -75,25 +86,47 @@ int main( int argc, char* argv[] ) {
     { LIKWID_MARKER_STOP( "iterator" ); }
     #endif
 #else
+    // Time parallel integration of several output intervals at once, see Solver::iterateParareal
+    while ( system.parareal_slices > 0 and system.p.t < system.t_max and running ) {
+        TimeThis( solver.iterateParareal( [&]() {
+            solver.cacheValues();
+            solver.cacheMatrices();
+            running = plotSFMLWindow( solver, system.p.t, complete_duration, system.iteration );
+        } ),
+                  "Main-Loop" );
+        complete_duration = PHOENIX::TimeIt::totalRuntime();
+
+        system.printCMD( complete_duration, system.iteration );
+    }
     while ( system.p.t < system.t_max and running ) {
         TimeThis(
             // Iterate #output_every ps
             auto start = system.p.t; while ( ( ( not system.disableRender and system.p.t < start + system.output_every ) or ( system.disableRender and system.p.t < out_every_iterations * system.output_every ) ) and solver.iterate() ) {
-                // If we use live rendering, do not adjust dt
-                if ( not system.disableRender )
+                // Adaptive iterators propose the next dt themselves
+                system.p.dt = solver.adaptive_dt > 0.0 ? solver.adaptive_dt : dt;
+                // If we use live rendering or dense output, do not adjust dt
+                if ( not system.disableRender or dense_output )
                     continue;
                 // Check if t+dt would overshoot out_every_iterations*output_every, adjust dt accordingly
-                system.p.dt = dt;
                 if ( system.p.t + system.p.dt > out_every_iterations * system.output_every ) {
                     auto next_dt = out_every_iterations * system.output_every - system.p.t;
                     if ( next_dt > 0 )
                         system.p.dt = next_dt;
                 }
-            } out_every_iterations++;
+            } if ( dense_output ) solver.beginDenseOutput( std::min<PHOENIX::Type::real>( out_every_iterations * system.output_every, system.t_max ) );
+            out_every_iterations++;
+            // Output and rendering need the physical wavefunction and reservoir, so complete a pending SSFM half step or reservoir cycle
+            solver.completeSplitStep();
+            solver.completeReservoirCycle();
             // Cache the history and max values
             solver.cacheValues();
             // Output Matrices if enabled
             solver.cacheMatrices();
+            // Continue from the end of the step. The final state is kept at the output time.
+            if ( system.p.t < system.t_max )
+                solver.endDenseOutput();
+            // Adapt dt to the stability limit of the current state
+            adapt_timestep();
             // Plot
             running = plotSFMLWindow( solver, system.p.t, complete_duration, system.iteration );
             , "Main-Loop" );
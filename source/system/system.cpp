@@ -48,18 +48,33 @@ PHOENIX::SystemParameters::SystemParameters() {
     output_every = 1;
     dt_max = 3;
     dt_min = 0.0001; // also dt_delta
-    tolerance = 1E-1;
+    tolerance = 1E-4;
     do_overwrite_dt = true;
 
     // FFT Mask every x ps
     fft_every = 1; // ps
+    // FFTW Planner effort and wisdom file. Plans are cached, so measuring once pays off.
+    fft_planner = "measure";
+    fft_wisdom = "";
 
     // Kernel Block Size
     block_size = 256;
     omp_max_threads = omp_get_max_threads();
+    fft_threads = omp_max_threads;
 
     // Default Solver is RK4
     iterator = "rk4";
+    ssfm_fused = false;
+    reservoir_subcycle = 1;
+    stencil_order = 2;
+    use_spectral_laplacian = false;
+    auto_timestep = 0.0;
+    halo_depth = 0;
+    local_timestep_levels = 0;
+    parareal_slices = 0;
+    parareal_coarse_iterator = "rk3";
+    parareal_coarse_dt = 0.0;
+    parareal_tolerance = 1E-6;
 
     // Output of Variables
     output_keys = { "mat", "scalar" };
@@ -156,6 +171,14 @@ void PHOENIX::SystemParameters::calculateAuto() {
     p.m_eff_scaled = -0.5 * p.h_bar_s * p.h_bar_s / p.m_eff;
     // Magic timestep
     magic_timestep = 0.5 * p.dx * p.dy / dt_scaling_factor;
+    // The higher order stencils have a larger spectral radius of 16/3 and 272/45 instead of 4 per direction
+    if ( p.stencil_radius == 2 )
+        magic_timestep *= 3.0 / 4.0;
+    else if ( p.stencil_radius == 3 )
+        magic_timestep *= 45.0 / 68.0;
+    // The largest eigenvalue of the spectral Laplacian is (pi/dx)^2 per direction
+    else if ( p.stencil_radius == 0 )
+        magic_timestep *= 4.0 / ( 3.1415926535 * 3.1415926535 );
     if ( do_overwrite_dt ) {
         p.dt = magic_timestep;
     }
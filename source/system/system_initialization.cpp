@@ -2,11 +2,13 @@
 #include <algorithm>
 #include <ranges>
 #include <random>
+#include <thread>
 #include "system/system_parameters.hpp"
 #include "system/filehandler.hpp"
 #include "misc/commandline_io.hpp"
 #include "misc/escape_sequences.hpp"
 #include "system/envelope.hpp"
+#include "solver/runge_kutta_tableau.hpp"
 #include "omp.h"
 
 void PHOENIX::SystemParameters::init( int argc, char** argv ) {
@@ -44,6 +46,23 @@ void PHOENIX::SystemParameters::init( int argc, char** argv ) {
     omp_max_threads = 4;
     if ( ( index = PHOENIX::CLIO::findInArgv( "--threads", argc, argv ) ) != -1 )
         omp_max_threads = (int)PHOENIX::CLIO::getNextInput( argv, argc, "threads", ++index );
+
+    // Oversubscription guard. The kernels and the FFTW transforms share the same OpenMP pool and never
+    // run at the same time, so FFTW may use at most omp_max_threads threads. The std::async output
+    // writers are joined before the solver continues, so they do not add to the peak thread count.
+    const Type::uint32 hardware_threads = std::max<Type::uint32>( 1, std::thread::hardware_concurrency() );
+    if ( omp_max_threads > hardware_threads ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "Requested " + std::to_string( omp_max_threads ) + " threads, but only " + std::to_string( hardware_threads ) + " are available. Reducing to " + std::to_string( hardware_threads ), PHOENIX::CLIO::Control::Warning ) << std::endl;
+        omp_max_threads = hardware_threads;
+    }
+    omp_max_threads = std::max<Type::uint32>( 1, omp_max_threads );
+    fft_threads = omp_max_threads;
+    if ( ( index = PHOENIX::CLIO::findInArgv( "--fftThreads", argc, argv ) ) != -1 )
+        fft_threads = (int)PHOENIX::CLIO::getNextInput( argv, argc, "fft_threads", ++index );
+    if ( fft_threads > omp_max_threads or fft_threads < 1 ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "FFT threads clamped to the " + std::to_string( omp_max_threads ) + " solver threads", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        fft_threads = omp_max_threads;
+    }
     omp_set_num_threads( omp_max_threads );
 
     if ( ( index = PHOENIX::CLIO::findInArgv( "--blocksize", argc, argv ) ) != -1 )
@@ -89,6 +108,9 @@ void PHOENIX::SystemParameters::init( int argc, char** argv ) {
         do_overwrite_dt = false;
         std::cout << PHOENIX::CLIO::prettyPrint( "Overwritten (initial) dt to " + PHOENIX::CLIO::to_str( p.dt ), PHOENIX::CLIO::Control::Warning ) << std::endl;
     }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "--autoTimestep", argc, argv ) ) != -1 ) {
+        auto_timestep = PHOENIX::CLIO::getNextInput( argv, argc, "auto_timestep", ++index );
+    }
     if ( ( index = PHOENIX::CLIO::findInArgv( "--tol", argc, argv ) ) != -1 ) {
         tolerance = PHOENIX::CLIO::getNextInput( argv, argc, "tol", ++index );
     }
@@ -104,23 +126,64 @@ void PHOENIX::SystemParameters::init( int argc, char** argv ) {
     if ( ( index = PHOENIX::CLIO::findInArgv( "--fftEvery", argc, argv ) ) != -1 ) {
         fft_every = PHOENIX::CLIO::getNextInput( argv, argc, "fft_every", ++index );
     }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "--fftPlanner", argc, argv ) ) != -1 ) {
+        fft_planner = PHOENIX::CLIO::getNextStringInput( argv, argc, "fft_planner", ++index );
+    }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "--fftWisdom", argc, argv ) ) != -1 ) {
+        fft_wisdom = PHOENIX::CLIO::getNextStringInput( argv, argc, "fft_wisdom", ++index );
+    }
 
     // Choose the iterator
     iterator = "rk4";
     if ( ( index = PHOENIX::CLIO::findInArgv( "-ssfm", argc, argv ) ) != -1 ) {
         iterator = "ssfm";
     }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "-rk45", argc, argv ) ) != -1 ) {
+        iterator = "rk45";
+    }
     if ( ( index = PHOENIX::CLIO::findInArgv( "--iterator", argc, argv ) ) != -1 ) {
         std::string it = PHOENIX::CLIO::getNextStringInput( argv, argc, "iterator", ++index );
         iterator = it;
     }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "-ssfmFused", argc, argv ) ) != -1 ) {
+        ssfm_fused = true;
+    }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "--reservoirSubcycle", argc, argv ) ) != -1 ) {
+        reservoir_subcycle = (Type::uint32)PHOENIX::CLIO::getNextInput( argv, argc, "reservoir_subcycle", ++index );
+    }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "--haloDepth", argc, argv ) ) != -1 ) {
+        halo_depth = (Type::uint32)PHOENIX::CLIO::getNextInput( argv, argc, "halo_depth", ++index );
+    }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "--localTimestep", argc, argv ) ) != -1 ) {
+        local_timestep_levels = (Type::uint32)PHOENIX::CLIO::getNextInput( argv, argc, "local_timestep_levels", ++index );
+    }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "--parareal", argc, argv ) ) != -1 ) {
+        parareal_slices = (Type::uint32)PHOENIX::CLIO::getNextInput( argv, argc, "parareal_slices", ++index );
+        parareal_coarse_dt = PHOENIX::CLIO::getNextInput( argv, argc, "parareal_coarse_dt", index );
+        parareal_tolerance = PHOENIX::CLIO::getNextInput( argv, argc, "parareal_tolerance", index );
+    }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "--pararealCoarse", argc, argv ) ) != -1 ) {
+        parareal_coarse_iterator = PHOENIX::CLIO::getNextStringInput( argv, argc, "parareal_coarse_iterator", ++index );
+    }
+    if ( ( index = PHOENIX::CLIO::findInArgv( "--stencil", argc, argv ) ) != -1 ) {
+        if ( ++index < argc and std::string( argv[index] ) == "spectral" )
+            use_spectral_laplacian = true;
+        else
+            stencil_order = (Type::uint32)PHOENIX::CLIO::getNextInput( argv, argc, "stencil_order", index );
+    }
+    // The spectral Laplacian is evaluated on the full grid, so the stages do not consume any halo
+    p.stencil_radius = use_spectral_laplacian ? 0 : ( stencil_order == 4 ? 2 : ( stencil_order == 6 ? 3 : 1 ) );
 
-    std::map<std::string, Type::uint32> halo_size_for_it = { { "rk4", 4 }, { "ssfm", 0 }, { "newton", 1 } };
+    std::map<std::string, Type::uint32> halo_size_for_it = { { "ralston", RungeKutta::haloSize<RungeKutta::Ralston>() }, { "rk3", RungeKutta::haloSize<RungeKutta::RK3>() }, { "ssprk3", RungeKutta::haloSize<RungeKutta::SSPRK3>() }, { "rk4", RungeKutta::haloSize<RungeKutta::RK4>() }, { "lsrk4", RungeKutta::haloSize<RungeKutta::LowStorageRK4>() }, { "rk45", 7 }, { "ssfm", 0 }, { "ssfm4", 0 }, { "ifrk4", 0 }, { "adi", 0 }, { "newton", 1 } };
     if ( halo_size_for_it.find( iterator ) == halo_size_for_it.end() ) {
         std::cout << PHOENIX::CLIO::prettyPrint( "Iterator '" + iterator + "' is not implemented. Falling back to 'rk4'", PHOENIX::CLIO::Control::Warning ) << std::endl;
         iterator = "rk4";
     }
-    p.halo_size = halo_size_for_it[iterator];
+    // Every stencil evaluation consumes stencil_radius cells of the halo
+    p.halo_size = halo_size_for_it[iterator] * p.stencil_radius;
+    // The halo holds the stage evaluations between two exchanges, see --haloDepth
+    if ( halo_depth > 0 )
+        p.halo_size = halo_depth * p.stencil_radius;
     std::cout << PHOENIX::CLIO::prettyPrint( "Halo Size for iterator '" + iterator + "' = " + std::to_string( p.halo_size ), PHOENIX::CLIO::Control::Info ) << std::endl;
 
     if ( ( index = PHOENIX::CLIO::findInArgv( { "initRandom", "iR" }, argc, argv, 0, "--" ) ) != -1 ) {
@@ -229,8 +292,15 @@ void PHOENIX::SystemParameters::init( int argc, char** argv ) {
     if ( ( index = PHOENIX::CLIO::findInArgv( "-noReservoir", argc, argv ) ) != -1 ) {
         use_reservoir = false;
     }
+    // The adiabatic reservoir is evaluated from the pump and Psi in the kernels, so no reservoir matrices are needed
+    use_adiabatic_reservoir = false;
+    if ( ( index = PHOENIX::CLIO::findInArgv( "-adiabaticReservoir", argc, argv ) ) != -1 ) {
+        use_adiabatic_reservoir = use_reservoir and use_pumps;
+        use_reservoir = false;
+    }
 
     std::cout << PHOENIX::CLIO::prettyPrint( "Using Reservoir: " + std::to_string( use_reservoir ), PHOENIX::CLIO::Control::Info ) << std::endl;
+    std::cout << PHOENIX::CLIO::prettyPrint( "Using Adiabatic Reservoir: " + std::to_string( use_adiabatic_reservoir ), PHOENIX::CLIO::Control::Info ) << std::endl;
     std::cout << PHOENIX::CLIO::prettyPrint( "Using Pumps: " + std::to_string( use_pumps ), PHOENIX::CLIO::Control::Info ) << std::endl;
     std::cout << PHOENIX::CLIO::prettyPrint( "Using Pulses: " + std::to_string( use_pulses ), PHOENIX::CLIO::Control::Info ) << std::endl;
     std::cout << PHOENIX::CLIO::prettyPrint( "Using Potentials: " + std::to_string( use_potentials ), PHOENIX::CLIO::Control::Info ) << std::endl;
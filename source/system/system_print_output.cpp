@@ -134,13 +134,33 @@ void PHOENIX::SystemParameters::printHelp() {
     std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "Example: --subgrids 2 2 results in 2*2 = 4 subgrids. --subgrids 1 5 results in 1*5 = 5 subgrids." ) << std::endl;
     std::cout << PHOENIX::CLIO::unifyLength( "--tstep", "<double>", "Timestep. Default is " + PHOENIX::CLIO::to_str( magic_timestep ) + " ps. It's advised to leave this parameter at its default value." ) << std::endl;
     std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "Example: --tstep 0.1 sets the timestep to 0.1ps." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--autoTimestep", "<double>", "Set dt to this fraction of the estimated stability limit after every output. Fixed timestep iterators only." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "The limit is estimated from the grid, the iterator and max |Psi|^2, reservoir, pump and potential." ) << std::endl;
     std::cout << PHOENIX::CLIO::unifyLength( "--tmax", "<double>", "Timelimit. Default is " + PHOENIX::CLIO::to_str( t_max ) + " ps" ) << std::endl;
     std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "Example: --tmax 1000 sets the simulation time to 1000ps." ) << std::endl;
-    std::cout << PHOENIX::CLIO::unifyLength( "--iterator", "<string>", "RK4 or SSFM" ) << std::endl;
-    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "Example: --iterator rk4 sets the iterator to RK4. --iterator ssfm sets the iterator to SSFM." ) << std::endl;
-    //std::cout << PHOENIX::CLIO::unifyLength( "-rk45", "no arguments", "Shortcut to use RK45" ) << std::endl;
-    //std::cout << PHOENIX::CLIO::unifyLength( "--rk45dt", "<double> <double>", "dt_min and dt_max for RK45 method" ) << std::endl;
-    //std::cout << PHOENIX::CLIO::unifyLength( "--tol", "<double>", "RK45 Tolerance. Default is " + PHOENIX::CLIO::to_str( tolerance ) + " ps" ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--iterator", "<string>", "RK4, LSRK4, IFRK4, RK45, RK3, SSPRK3, Ralston, SSFM, SSFM4 or ADI" ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "Example: --iterator rk4 sets the iterator to RK4. --iterator ssfm sets the iterator to SSFM. --iterator ssfm4 uses the fourth order Forest-Ruth splitting." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "--iterator lsrk4 uses a five stage, fourth order low storage RK that needs a single k matrix instead of four." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "--iterator ifrk4 propagates the kinetic term exactly in k-space and uses RK4 for the rest. Allows much larger dt on fine grids." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "--iterator adi uses an unconditionally stable Crank-Nicolson ADI scheme for the kinetic term. Supports zero boundaries." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "-ssfmFused", "no arguments", "Merge the linear half steps of consecutive SSFM steps. Halves the number of FFTs between outputs." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--reservoirSubcycle", "<int>", "Advance the reservoir only every n steps of RK4, RK3, SSPRK3 or Ralston. Default is " + std::to_string( reservoir_subcycle ) ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "The wavefunction couples to the reservoir predicted for the middle of each cycle. Use if the reservoir is much slower than Psi." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--haloDepth", "<int>", "Stage evaluations between two halo exchanges of RK4, RK3, SSPRK3 or Ralston. Default is the number of stages." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "1 exchanges before every stage. A multiple of the stages exchanges only every few steps, which pays off for large subgrids." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--localTimestep", "<int>", "Let every subgrid subcycle dt with dt/2, dt/4, ... down to dt/2^n as its local stability requires. RK4, RK3, SSPRK3 or Ralston." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "dt is then the step of the quiescent subgrids. Halos between levels are interpolated in time. Default is " + std::to_string( local_timestep_levels ) ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--parareal", "<int> <double> <double>", "Parareal: integrate <int> output intervals at once, each on its own share of the threads, corrected by a serial coarse" ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "propagator with dt = <double> until the relative change is below <double>. CPU only. Fixed timestep RK iterators only." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--pararealCoarse", "<string>", "Iterator of the coarse propagator: newton, ralston, rk3, ssprk3 or rk4. Default is '" + parareal_coarse_iterator + "'" ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--stencil", "<int>", "Order of the finite difference Laplacian: 2 (5-point), 4 (9-point) or 6 (13-point). Default is " + std::to_string( stencil_order ) ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "Higher orders reach the same accuracy on coarser grids. Scalar model and the RK and Newton iterators only." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--stencil", "spectral", "Evaluate the Laplacian of every stage by FFT. Periodic boundaries, scalar model and rk4, rk3, ssprk3 or ralston only." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "-adiabaticReservoir", "no arguments", "Replace the reservoir by its steady state P/(gamma_r + R|Psi|^2). No reservoir matrices are stored." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "Use if the reservoir is much faster than Psi. Supported by rk4, rk3, ssprk3, ralston, lsrk4, rk45 and newton." ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "-rk45", "no arguments", "Shortcut to use the adaptive Dormand-Prince RK45" ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--rk45dt", "<double> <double>", "dt_min and dt_max for RK45 method. Default is " + PHOENIX::CLIO::to_str( dt_min ) + " " + PHOENIX::CLIO::to_str( dt_max ) + " ps" ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--tol", "<double>", "RK45 Tolerance for the maximum local error relative to max|Psi|. Default is " + PHOENIX::CLIO::to_str( tolerance ) ) << std::endl;
     //std::cout << PHOENIX::CLIO::unifyLength( "-ssfm", "no arguments", "Shortcut to use SSFM" ) << std::endl;
     std::cout << PHOENIX::CLIO::unifyLength( "--imagTime", "<double>", "Use imaginary time propagation with normalization constant. Default is " + PHOENIX::CLIO::to_str( imag_time_amplitude ) ) << std::endl;
     std::cout << PHOENIX::CLIO::unifyLength( "...", "...", "Example: --imagTime 1 sets the imaginary time amplitude to 1, --imagTime 10 sets the normalization constant to 10." ) << std::endl;
@@ -182,6 +202,10 @@ void PHOENIX::SystemParameters::printHelp() {
     // Additional Parameters
     std::cout << "Additional Parameters:" << std::endl;
     std::cout << PHOENIX::CLIO::unifyLength( "--fftEvery", "<int>", "Apply FFT Filter every x ps" ) << std::endl;
+#ifdef USE_CPU
+    std::cout << PHOENIX::CLIO::unifyLength( "--fftPlanner", "<string>", "FFTW planner effort: estimate, measure, patient or exhaustive. Default is " + fft_planner ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--fftWisdom", "<string>", "Path to a FFTW wisdom file. Loaded before planning, saved when new plans were created." ) << std::endl;
+#endif
     std::cout << PHOENIX::CLIO::unifyLength( "--initRandom", "<double>", "Amplitude. Randomly initialize Psi" ) << std::endl;
 
     std::cout << PHOENIX::CLIO::fillLine( console_width, major_seperator ) << std::endl;
@@ -195,6 +219,7 @@ void PHOENIX::SystemParameters::printHelp() {
 
 #ifdef USE_CPU
     std::cout << PHOENIX::CLIO::unifyLength( "--threads", "<int>", "Default is " + std::to_string( omp_max_threads ) + " Threads" ) << std::endl;
+    std::cout << PHOENIX::CLIO::unifyLength( "--fftThreads", "<int>", "Threads used by FFTW. Default is --threads, at most --threads" ) << std::endl;
 #endif
 
     std::cout << PHOENIX::CLIO::fillLine( console_width, major_seperator ) << std::endl;
@@ -288,6 +313,7 @@ void PHOENIX::SystemParameters::printSummary( std::map<std::string, std::vector<
 #ifdef USE_CPU
     std::cout << "Device Used: " << EscapeSequence::BOLD << EscapeSequence::YELLOW << "CPU" << EscapeSequence::RESET << std::endl;
     std::cout << EscapeSequence::GRAY << "  CPU cores utilized: " << omp_max_threads << EscapeSequence::RESET << std::endl;
+    std::cout << EscapeSequence::GRAY << "  FFT threads: " << fft_threads << EscapeSequence::RESET << std::endl;
 #else
     int nDevices;
     cudaGetDeviceCount( &nDevices );
@@ -1,4 +1,6 @@
+#include <map>
 #include "system/system_parameters.hpp"
+#include "solver/runge_kutta_tableau.hpp"
 #include "misc/escape_sequences.hpp"
 #include "misc/commandline_io.hpp"
 
@@ -46,6 +48,114 @@ void PHOENIX::SystemParameters::validateInputs() {
         std::cout << PHOENIX::CLIO::prettyPrint( "dt_min = " + PHOENIX::CLIO::to_str( dt_min ) + " cannot be negative!", PHOENIX::CLIO::Control::Warning ) << std::endl;
         valid = false;
     }
+    if ( reservoir_subcycle == 0 ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "reservoirSubcycle has to be at least 1!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( reservoir_subcycle > 1 and not( iterator == "rk4" or iterator == "rk3" or iterator == "ssprk3" or iterator == "ralston" ) ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "reservoirSubcycle is only supported by the fixed timestep RK iterators rk4, rk3, ssprk3 and ralston!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( use_adiabatic_reservoir and not( iterator == "rk4" or iterator == "rk3" or iterator == "ssprk3" or iterator == "ralston" or iterator == "lsrk4" or iterator == "rk45" or iterator == "newton" ) ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "adiabaticReservoir is only supported by the rk4, rk3, ssprk3, ralston, lsrk4, rk45 and newton iterators!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( use_adiabatic_reservoir and use_stochastic ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "adiabaticReservoir does not support the stochastic noise, which depends on the reservoir!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( stencil_order != 2 and stencil_order != 4 and stencil_order != 6 ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "stencil = " + std::to_string( stencil_order ) + " is not supported! Use 2, 4 or 6.", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( stencil_order > 2 and use_twin_mode ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "The higher order stencils are not supported in TE/TM mode!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( stencil_order > 2 and not( iterator == "rk4" or iterator == "rk3" or iterator == "ssprk3" or iterator == "ralston" or iterator == "lsrk4" or iterator == "rk45" or iterator == "newton" ) ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "The higher order stencils are only supported by the rk4, rk3, ssprk3, ralston, lsrk4, rk45 and newton iterators!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( auto_timestep < 0.0 or auto_timestep > 1.0 ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "autoTimestep = " + PHOENIX::CLIO::to_str( auto_timestep ) + " has to be a fraction between 0 and 1!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( auto_timestep > 0.0 and iterator == "rk45" ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "autoTimestep is not supported by the adaptive rk45 iterator!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( local_timestep_levels > 8 ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "localTimestep = " + std::to_string( local_timestep_levels ) + " is too large! Use at most 8 levels.", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( local_timestep_levels > 0 and not( iterator == "rk4" or iterator == "rk3" or iterator == "ssprk3" or iterator == "ralston" ) ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "localTimestep is only supported by the fixed timestep RK iterators rk4, rk3, ssprk3 and ralston!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( local_timestep_levels > 0 and ( use_spectral_laplacian or use_stochastic or reservoir_subcycle > 1 or auto_timestep > 0.0 ) ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "localTimestep cannot be combined with the spectral Laplacian, the stochastic noise, reservoirSubcycle or autoTimestep!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( parareal_slices > 0 ) {
+#ifndef USE_CPU
+        std::cout << PHOENIX::CLIO::prettyPrint( "parareal is only supported by the CPU version!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+#endif
+        if ( not( iterator == "rk4" or iterator == "rk3" or iterator == "ssprk3" or iterator == "ralston" ) ) {
+            std::cout << PHOENIX::CLIO::prettyPrint( "parareal is only supported by the fixed timestep RK iterators rk4, rk3, ssprk3 and ralston!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+            valid = false;
+        }
+        if ( not( parareal_coarse_iterator == "newton" or parareal_coarse_iterator == "rk4" or parareal_coarse_iterator == "rk3" or parareal_coarse_iterator == "ssprk3" or parareal_coarse_iterator == "ralston" ) ) {
+            std::cout << PHOENIX::CLIO::prettyPrint( "The coarse parareal propagator '" + parareal_coarse_iterator + "' is not supported! Use newton, rk4, rk3, ssprk3 or ralston.", PHOENIX::CLIO::Control::Warning ) << std::endl;
+            valid = false;
+        }
+        if ( parareal_coarse_dt <= 0.0 or parareal_tolerance <= 0.0 ) {
+            std::cout << PHOENIX::CLIO::prettyPrint( "The coarse dt and the tolerance of parareal have to be positive!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+            valid = false;
+        }
+        if ( use_spectral_laplacian or use_stochastic or imag_time_amplitude != 0.0 or use_fft_mask or reservoir_subcycle > 1 or local_timestep_levels > 0 or auto_timestep > 0.0 ) {
+            std::cout << PHOENIX::CLIO::prettyPrint( "parareal cannot be combined with the spectral Laplacian, the stochastic noise, imaginary time propagation, the FFT mask, reservoirSubcycle, localTimestep or autoTimestep!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+            valid = false;
+        }
+    }
+    if ( halo_depth > 0 ) {
+        const std::map<std::string, Type::uint32> stages = { { "ralston", RungeKutta::Ralston::stages }, { "rk3", RungeKutta::RK3::stages }, { "ssprk3", RungeKutta::SSPRK3::stages }, { "rk4", RungeKutta::RK4::stages } };
+        if ( not stages.contains( iterator ) ) {
+            std::cout << PHOENIX::CLIO::prettyPrint( "haloDepth is only supported by the fixed timestep RK iterators rk4, rk3, ssprk3 and ralston!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+            valid = false;
+        } else if ( halo_depth > 1 and halo_depth % stages.at( iterator ) != 0 ) {
+            std::cout << PHOENIX::CLIO::prettyPrint( "haloDepth = " + std::to_string( halo_depth ) + " has to be 1 or a multiple of the " + std::to_string( stages.at( iterator ) ) + " stages of '" + iterator + "'!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+            valid = false;
+        } else if ( halo_depth > stages.at( iterator ) and ( use_stochastic or imag_time_amplitude != 0.0 or not( p.periodic_boundary_x and p.periodic_boundary_y ) ) ) {
+            // The halo left from an exchange is evolved like the subgrid it was copied from, which the noise, the normalization and the zero boundaries break
+            std::cout << PHOENIX::CLIO::prettyPrint( "Exchanging the halos less than once per step requires periodic boundaries and cannot be combined with the stochastic noise or imaginary time propagation!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+            valid = false;
+        }
+        if ( use_spectral_laplacian or reservoir_subcycle > 1 or local_timestep_levels > 0 ) {
+            std::cout << PHOENIX::CLIO::prettyPrint( "haloDepth cannot be combined with the spectral Laplacian, reservoirSubcycle or localTimestep!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+            valid = false;
+        }
+    }
+    if ( use_spectral_laplacian and not( p.periodic_boundary_x and p.periodic_boundary_y ) ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "The spectral Laplacian requires periodic boundaries!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( use_spectral_laplacian and use_twin_mode ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "The spectral Laplacian is not supported in TE/TM mode!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( use_spectral_laplacian and not( iterator == "rk4" or iterator == "rk3" or iterator == "ssprk3" or iterator == "ralston" ) ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "The spectral Laplacian is only supported by the rk4, rk3, ssprk3 and ralston iterators!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( p.halo_size > p.subgrid_N_c or p.halo_size > p.subgrid_N_r ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "The halo size " + std::to_string( p.halo_size ) + " is larger than the subgrids. Use fewer subgrids!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
+    if ( iterator == "adi" and use_twin_mode and p.delta_LT != 0.0 ) {
+        std::cout << PHOENIX::CLIO::prettyPrint( "The ADI iterator does not support the TE-TM splitting delta_LT, because it couples the directions!", PHOENIX::CLIO::Control::Warning ) << std::endl;
+        valid = false;
+    }
     if ( abs( p.dt > 1.1 * magic_timestep ) ) {
         std::cout << PHOENIX::CLIO::prettyPrint( "dt = " + PHOENIX::CLIO::to_str( p.dt ) + " is very large! Is this intended?", PHOENIX::CLIO::Control::Warning ) << std::endl;
     }